@@ -0,0 +1,29 @@
+# Host platform, architecture and shared library suffix of the native
+# game modules, shared by the top level Makefile
+
+ifeq ($(OS),Windows_NT)
+  PLATFORM = mingw32
+else
+  PLATFORM = $(shell uname -s | tr A-Z a-z)
+endif
+
+ifndef ARCH
+  ARCH := $(shell uname -m)
+  ifeq ($(ARCH),aarch64)
+    ARCH = arm64
+  endif
+  ifeq ($(ARCH),i686)
+    ARCH = x86
+  endif
+endif
+
+ifeq ($(PLATFORM),mingw32)
+  SHLIBEXT = dll
+  SHLIBLDFLAGS = -shared
+else ifeq ($(PLATFORM),darwin)
+  SHLIBEXT = dylib
+  SHLIBLDFLAGS = -dynamiclib
+else
+  SHLIBEXT = so
+  SHLIBLDFLAGS = -shared
+endif
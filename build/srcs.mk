@@ -4,7 +4,7 @@ QA_SRC = \
  ai_chat ai_cmd ai_dmnet ai_dmq3 ai_main ai_team ai_vcmd \
  bg_lib bg_misc bg_pmove bg_slidemove \
  g_active g_arenas g_bot g_client g_cmds g_combat g_items g_mem g_misc \
- g_missile g_mover g_rotation g_session g_spawn g_svcmds g_target g_team \
+ g_missile g_mover g_profile g_rotation g_session g_spawn g_svcmds g_target g_team \
  g_trigger g_unlagged g_utils g_weapon \
  q_math q_shared \
 
@@ -14,8 +14,8 @@ ifeq ($(CONFIG),missionpack)
 CG_SRC = \
  cg_main $(CGDIR)/cg_syscalls.asm \
  cg_consolecmds cg_draw cg_drawtools cg_effects cg_ents cg_event cg_info \
- cg_localents cg_marks cg_newdraw cg_players cg_playerstate \
- cg_predict cg_scoreboard cg_servercmds cg_snapshot cg_view cg_weapons \
+ cg_localents cg_marks cg_newdraw cg_players cg_playerstate cg_polys \
+ cg_predict cg_predictstats cg_scoreboard cg_servercmds cg_snapshot cg_view cg_weapons \
  ui_shared \
  bg_slidemove bg_pmove bg_lib bg_misc \
  q_math q_shared \
@@ -25,8 +25,8 @@ else
 CG_SRC = \
  cg_main $(CGDIR)/cg_syscalls.asm \
  cg_consolecmds cg_draw cg_drawtools cg_effects cg_ents cg_event cg_info \
- cg_localents cg_marks cg_players cg_playerstate cg_predict cg_scoreboard \
- cg_servercmds cg_snapshot cg_view cg_weapons \
+ cg_localents cg_marks cg_players cg_playerstate cg_polys cg_predict cg_predictstats \
+ cg_scoreboard cg_servercmds cg_snapshot cg_view cg_weapons \
  bg_slidemove bg_pmove bg_lib bg_misc \
  q_math q_shared \
 
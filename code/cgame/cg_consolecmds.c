@@ -77,7 +77,7 @@ static void CG_ScoresDown_f( void ) {
 		// the scores are more than two seconds out of data,
 		// so request new ones
 		cg.scoresRequestTime = cg.time;
-		trap_SendClientCommand( "score" );
+		CG_RequestScores();
 
 		// leave the current scores up if they were already
 		// displayed, but if this is the first hit, clear them out
@@ -650,7 +650,9 @@ static consoleCommand_t	commands[] = {
 	{ "tv_backward", CG_TVBackward_f },
 	{ "+tv_scrub", CG_TVScrubDown_f },
 	{ "-tv_scrub", CG_TVScrubUp_f },
-	{ "loaddeferred", CG_LoadDeferredPlayers }
+	{ "loaddeferred", CG_LoadDeferredPlayers },
+	{ "localents", CG_LocalEntityStats_f },
+	{ "predictstats", CG_PredictStats_f }
 };
 
 
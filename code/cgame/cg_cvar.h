@@ -39,6 +39,8 @@ CG_CVAR( cg_crosshairY, "cg_crosshairY", "0", CVAR_ARCHIVE )
 CG_CVAR( cg_brassTime, "cg_brassTime", "2500", CVAR_ARCHIVE )
 CG_CVAR( cg_simpleItems, "cg_simpleItems", "0", CVAR_ARCHIVE )
 CG_CVAR( cg_addMarks, "cg_marks", "1", CVAR_ARCHIVE )
+CG_CVAR( cg_markBudget, "cg_markBudget", "4096", CVAR_ARCHIVE )
+CG_CVAR( cg_batchPolys, "cg_batchPolys", "1", CVAR_ARCHIVE )
 CG_CVAR( cg_lagometer, "cg_lagometer", "1", CVAR_ARCHIVE )
 CG_CVAR( cg_railTrailTime, "cg_railTrailTime", "400", CVAR_ARCHIVE  )
 CG_CVAR( cg_railTrailRadius, "cg_railTrailRadius", "0", CVAR_ARCHIVE  )
@@ -61,6 +63,7 @@ CG_CVAR( cg_errorDecay, "cg_errordecay", "100", 0 )
 CG_CVAR( cg_nopredict, "cg_nopredict", "0", 0 )
 CG_CVAR( cg_noPlayerAnims, "cg_noplayeranims", "0", CVAR_CHEAT )
 CG_CVAR( cg_showmiss, "cg_showmiss", "0", 0 )
+CG_CVAR( cg_predictStats, "cg_predictStats", "0", 0 )
 CG_CVAR( cg_footsteps, "cg_footsteps", "1", CVAR_CHEAT )
 CG_CVAR( cg_tracerChance, "cg_tracerchance", "0.4", CVAR_CHEAT )
 CG_CVAR( cg_tracerWidth, "cg_tracerwidth", "1", CVAR_CHEAT )
@@ -112,6 +115,7 @@ CG_CVAR( cg_timescaleFadeSpeed, "cg_timescaleFadeSpeed", "0", 0 )
 CG_CVAR( cg_timescale, "timescale", "1", 0 )
 CG_CVAR( cg_scorePlum, "cg_scorePlums", "1", CVAR_USERINFO | CVAR_ARCHIVE )
 CG_CVAR( cg_damagePlums, "cg_damagePlums", "0", CVAR_USERINFO | CVAR_ARCHIVE )
+CG_CVAR( cg_compactScores, "cg_compactScores", "0", CVAR_USERINFO | CVAR_ARCHIVE )
 CG_CVAR( cg_smoothClients, "cg_smoothClients", "0", CVAR_USERINFO | CVAR_ARCHIVE )
 CG_CVAR( cg_cameraMode, "com_cameraMode", "0", CVAR_CHEAT )
 CG_CVAR( cg_noTaunt, "cg_noTaunt", "0", CVAR_ARCHIVE )
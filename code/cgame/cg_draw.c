@@ -2979,6 +2979,7 @@ static void CG_Draw2D( stereoFrame_t stereoFrame )
 	CG_DrawTeamVote();
 
 	CG_DrawLagometer();
+	CG_DrawPredictStats();
 
 #ifdef MISSIONPACK
 	if (!cg_paused.integer) {
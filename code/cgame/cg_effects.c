@@ -718,6 +718,8 @@ void CG_Bleed( vec3_t origin, vec3_t dir, int entityNum, int weapon ) {
 
 		le->radius = re->radius;
 
+		CG_PredictBloodImpact( le );
+
 		// don't show player's own blood in view
 		if ( isPlayer ) {
 			re->renderfx |= RF_THIRD_PERSON;
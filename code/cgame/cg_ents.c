@@ -705,6 +705,29 @@ void CG_AdjustPositionForMover( const vec3_t in, int moverNum, int fromTime, int
 }
 
 
+/*
+=============================
+CG_LerpEntityPosition
+
+Blends the positions evaluated at the current and the next snapshot
+=============================
+*/
+static void CG_LerpEntityPosition( centity_t *cent, const vec3_t origin, const vec3_t angles,
+								  const vec3_t nextOrigin, const vec3_t nextAngles ) {
+	float		f;
+
+	f = cg.frameInterpolation;
+
+	cent->lerpOrigin[0] = origin[0] + f * ( nextOrigin[0] - origin[0] );
+	cent->lerpOrigin[1] = origin[1] + f * ( nextOrigin[1] - origin[1] );
+	cent->lerpOrigin[2] = origin[2] + f * ( nextOrigin[2] - origin[2] );
+
+	cent->lerpAngles[0] = LerpAngle( angles[0], nextAngles[0], f );
+	cent->lerpAngles[1] = LerpAngle( angles[1], nextAngles[1], f );
+	cent->lerpAngles[2] = LerpAngle( angles[2], nextAngles[2], f );
+}
+
+
 /*
 =============================
 CG_InterpolateEntityPosition
@@ -712,7 +735,7 @@ CG_InterpolateEntityPosition
 */
 static void CG_InterpolateEntityPosition( centity_t *cent ) {
 	vec3_t		current, next;
-	float		f;
+	vec3_t		currentAngles, nextAngles;
 
 	// it would be an internal error to find an entity that interpolates without
 	// a snapshot ahead of the current one
@@ -720,33 +743,26 @@ static void CG_InterpolateEntityPosition( centity_t *cent ) {
 		CG_Error( "CG_InterpoateEntityPosition: cg.nextSnap == NULL" );
 	}
 
-	f = cg.frameInterpolation;
-
 	// this will linearize a sine or parabolic curve, but it is important
 	// to not extrapolate player positions if more recent data is available
 	BG_EvaluateTrajectory( &cent->currentState.pos, cg.snap->serverTime, current );
 	BG_EvaluateTrajectory( &cent->nextState.pos, cg.nextSnap->serverTime, next );
 
-	cent->lerpOrigin[0] = current[0] + f * ( next[0] - current[0] );
-	cent->lerpOrigin[1] = current[1] + f * ( next[1] - current[1] );
-	cent->lerpOrigin[2] = current[2] + f * ( next[2] - current[2] );
-
-	BG_EvaluateTrajectory( &cent->currentState.apos, cg.snap->serverTime, current );
-	BG_EvaluateTrajectory( &cent->nextState.apos, cg.nextSnap->serverTime, next );
-
-	cent->lerpAngles[0] = LerpAngle( current[0], next[0], f );
-	cent->lerpAngles[1] = LerpAngle( current[1], next[1], f );
-	cent->lerpAngles[2] = LerpAngle( current[2], next[2], f );
+	BG_EvaluateTrajectory( &cent->currentState.apos, cg.snap->serverTime, currentAngles );
+	BG_EvaluateTrajectory( &cent->nextState.apos, cg.nextSnap->serverTime, nextAngles );
 
+	CG_LerpEntityPosition( cent, current, currentAngles, next, nextAngles );
 }
 
+
 /*
 ===============
-CG_CalcEntityLerpPositions
+CG_EntityInterpolates
 
+True when the entity is lerped between snapshots instead of evaluated at cg.time
 ===============
 */
-static void CG_CalcEntityLerpPositions( centity_t *cent ) {
+static qboolean CG_EntityInterpolates( centity_t *cent ) {
 
 	// if this player does not want to see extrapolated players
 	if ( !cg_smoothClients.integer ) {
@@ -758,14 +774,45 @@ static void CG_CalcEntityLerpPositions( centity_t *cent ) {
 	}
 
 	if ( cent->interpolate && cent->currentState.pos.trType == TR_INTERPOLATE ) {
-		CG_InterpolateEntityPosition( cent );
-		return;
+		return qtrue;
 	}
 
 	// first see if we can interpolate between two snaps for
 	// linear extrapolated clients
 	if ( cent->interpolate && cent->currentState.pos.trType == TR_LINEAR_STOP &&
 											cent->currentState.number < MAX_CLIENTS) {
+		return qtrue;
+	}
+
+	return qfalse;
+}
+
+
+/*
+===============
+CG_AdjustEntityForMover
+
+adjust for riding a mover if it wasn't rolled into the predicted
+player state
+===============
+*/
+static void CG_AdjustEntityForMover( centity_t *cent ) {
+	if ( cent != &cg.predictedPlayerEntity ) {
+		CG_AdjustPositionForMover( cent->lerpOrigin, cent->currentState.groundEntityNum, 
+		cg.snap->serverTime, cg.time, cent->lerpOrigin, cent->lerpAngles, cent->lerpAngles );
+	}
+}
+
+
+/*
+===============
+CG_CalcEntityLerpPositions
+
+===============
+*/
+static void CG_CalcEntityLerpPositions( centity_t *cent ) {
+
+	if ( CG_EntityInterpolates( cent ) ) {
 		CG_InterpolateEntityPosition( cent );
 		return;
 	}
@@ -774,11 +821,72 @@ static void CG_CalcEntityLerpPositions( centity_t *cent ) {
 	BG_EvaluateTrajectory( &cent->currentState.pos, cg.time, cent->lerpOrigin );
 	BG_EvaluateTrajectory( &cent->currentState.apos, cg.time, cent->lerpAngles );
 
-	// adjust for riding a mover if it wasn't rolled into the predicted
-	// player state
-	if ( cent != &cg.predictedPlayerEntity ) {
-		CG_AdjustPositionForMover( cent->lerpOrigin, cent->currentState.groundEntityNum, 
-		cg.snap->serverTime, cg.time, cent->lerpOrigin, cent->lerpAngles, cent->lerpAngles );
+	CG_AdjustEntityForMover( cent );
+}
+
+
+/*
+===============
+CG_CalcSnapshotLerpPositions
+
+CG_CalcEntityLerpPositions for all entities of the snapshot. The
+trajectories are collected and evaluated in three batches (current
+snapshot, next snapshot and cg.time) instead of two to four calls
+per entity.
+===============
+*/
+static void CG_CalcSnapshotLerpPositions( void ) {
+	static const trajectory_t	*trLerp[MAX_ENTITIES_IN_SNAPSHOT * 2];
+	static const trajectory_t	*trNextLerp[MAX_ENTITIES_IN_SNAPSHOT * 2];
+	static const trajectory_t	*trNow[MAX_ENTITIES_IN_SNAPSHOT * 2];
+	static vec3_t		lerp[MAX_ENTITIES_IN_SNAPSHOT * 2];
+	static vec3_t		nextLerp[MAX_ENTITIES_IN_SNAPSHOT * 2];
+	static vec3_t		now[MAX_ENTITIES_IN_SNAPSHOT * 2];
+	static centity_t	*lerpEnts[MAX_ENTITIES_IN_SNAPSHOT];
+	static centity_t	*nowEnts[MAX_ENTITIES_IN_SNAPSHOT];
+	int			numLerp, numNow;
+	int			num, i;
+	centity_t	*cent;
+
+	numLerp = numNow = 0;
+	for ( num = 0 ; num < cg.snap->numEntities ; num++ ) {
+		cent = &cg_entities[ cg.snap->entities[ num ].number ];
+		if ( cent->currentState.eType >= ET_EVENTS ) {
+			continue;
+		}
+
+		if ( CG_EntityInterpolates( cent ) ) {
+			trLerp[ numLerp * 2 + 0 ] = &cent->currentState.pos;
+			trLerp[ numLerp * 2 + 1 ] = &cent->currentState.apos;
+			trNextLerp[ numLerp * 2 + 0 ] = &cent->nextState.pos;
+			trNextLerp[ numLerp * 2 + 1 ] = &cent->nextState.apos;
+			lerpEnts[ numLerp++ ] = cent;
+		} else {
+			trNow[ numNow * 2 + 0 ] = &cent->currentState.pos;
+			trNow[ numNow * 2 + 1 ] = &cent->currentState.apos;
+			nowEnts[ numNow++ ] = cent;
+		}
+	}
+
+	if ( numLerp ) {
+		if ( cg.nextSnap == NULL ) {
+			CG_Error( "CG_CalcSnapshotLerpPositions: cg.nextSnap == NULL" );
+		}
+		BG_EvaluateTrajectories( trLerp, numLerp * 2, cg.snap->serverTime, lerp, NULL );
+		BG_EvaluateTrajectories( trNextLerp, numLerp * 2, cg.nextSnap->serverTime, nextLerp, NULL );
+		for ( i = 0 ; i < numLerp ; i++ ) {
+			CG_LerpEntityPosition( lerpEnts[i], lerp[ i * 2 ], lerp[ i * 2 + 1 ],
+				nextLerp[ i * 2 ], nextLerp[ i * 2 + 1 ] );
+		}
+	}
+
+	if ( numNow ) {
+		BG_EvaluateTrajectories( trNow, numNow * 2, cg.time, now, NULL );
+		for ( i = 0 ; i < numNow ; i++ ) {
+			VectorCopy( now[ i * 2 ], nowEnts[i]->lerpOrigin );
+			VectorCopy( now[ i * 2 + 1 ], nowEnts[i]->lerpAngles );
+			CG_AdjustEntityForMover( nowEnts[i] );
+		}
 	}
 }
 
@@ -939,6 +1047,7 @@ static void CG_TeamBase( centity_t *cent ) {
 ===============
 CG_AddCEntity
 
+The lerp positions must be calculated already
 ===============
 */
 static void CG_AddCEntity( centity_t *cent ) {
@@ -947,9 +1056,6 @@ static void CG_AddCEntity( centity_t *cent ) {
 		return;
 	}
 
-	// calculate the current origin
-	CG_CalcEntityLerpPositions( cent );
-
 	// add automatic effects
 	CG_EntityEffects( cent );
 
@@ -1035,11 +1141,15 @@ void CG_AddPacketEntities( void ) {
 	// generate and add the entity from the playerstate
 	ps = &cg.predictedPlayerState;
 	BG_PlayerStateToEntityState( ps, &cg.predictedPlayerEntity.currentState, qfalse );
+	CG_CalcEntityLerpPositions( &cg.predictedPlayerEntity );
 	CG_AddCEntity( &cg.predictedPlayerEntity );
 
 	// lerp the non-predicted value for lightning gun origins
 	CG_CalcEntityLerpPositions( &cg_entities[ cg.snap->ps.clientNum ] );
 
+	// calculate the current origins of everything in the snapshot at once
+	CG_CalcSnapshotLerpPositions();
+
 	// add each entity sent over by the server
 	for ( num = 0 ; num < cg.snap->numEntities ; num++ ) {
 		cent = &cg_entities[ cg.snap->entities[ num ].number ];
@@ -42,7 +42,7 @@
 #define	MAX_STEP_CHANGE		32
 
 #define	MAX_VERTS_ON_POLY	10
-#define	MAX_MARK_POLYS		256
+#define	MAX_MARK_POLYS		1024
 
 #define STAT_MINUS			10	// num frame for '-' stats digit
 
@@ -217,6 +217,11 @@ typedef struct centity_s {
 
 typedef struct markPoly_s {
 	struct markPoly_s	*prevMark, *nextMark;
+	struct markPoly_s	*hashNext, **hashPrev;	// spatial hash chain
+	int			impact;			// all polys of one impact share this
+	vec3_t		origin;			// impact point, normal and radius
+	vec3_t		normal;
+	float		radius;
 	int			time;
 	qhandle_t	markShader;
 	qboolean	alphaFade;		// fade alpha instead of rgb
@@ -291,11 +296,37 @@ typedef struct localEntity_s {
 	leMarkType_t		leMarkType;		// mark to leave on fragment impact
 	leBounceSoundType_t	leBounceSoundType;
 
+	// LE_BLOOD_PARTICLE flight, traced once by CG_PredictBloodImpact
+	int				impactTime;			// 0 if nothing is hit before endTime
+	vec3_t			impactPoint;
+	vec3_t			impactNormal;
+	qboolean		impactWater;
+	vec3_t			flightMins, flightMaxs;
+
 	refEntity_t		refEntity;		
 } localEntity_t;
 
 //======================================================================
 
+typedef enum {
+	PREDICT_SKIPPED,		// demo, follow, cg_nopredict or commands lost
+	PREDICT_INCREMENTAL,	// no new snapshot, only the newest commands run
+	PREDICT_MATCHED,		// new snapshot matched a saved state
+	PREDICT_FULL,			// teleport or prediction error, everything replayed
+
+	PREDICT_NUM_MODES
+} predictMode_t;
+
+typedef struct {
+	predictMode_t	mode;
+	int				pmoves;		// commands run through Pmove
+	int				restored;	// commands taken from the saved states
+	int				traces;		// all CG_Trace calls of the frame
+	int				errorCode;	// CG_IsUnacceptableError result, 0 for none
+} predictFrame_t;
+
+//======================================================================
+
 
 typedef struct {
 	int				client;
@@ -560,6 +591,8 @@ typedef struct {
 
 	// scoreboard
 	int			scoresRequestTime;
+	int			scoreSeq;			// compact scoreboard we have, 0 for none
+	int			scorePendingSeq;	// compact scoreboard being received
 	int			numScores;
 	int			selectedScore;
 	int			teamScores[2];
@@ -1138,6 +1171,9 @@ typedef struct {
 	int				numInlineModels;
 	qhandle_t		inlineDrawModel[MAX_MODELS];
 	vec3_t			inlineModelMidpoints[MAX_MODELS];
+	vec3_t			inlineModelMins[MAX_MODELS];
+	vec3_t			inlineModelMaxs[MAX_MODELS];
+	float			inlineModelRadius[MAX_MODELS];		// around the model origin
 
 	clientInfo_t	clientinfo[MAX_CLIENTS];
 
@@ -1191,6 +1227,7 @@ typedef struct {
 #endif
 
 	qboolean		tvPlayback;		// playing back a TV demo (\tv\1 in serverinfo)
+	qboolean		compactScores;	// server sends "scd" scoreboard deltas
 
 	qboolean		tvScrubActive;		// currently scrubbing the timeline
 	int				tvScrubKey;			// keycode that activated scrub (for phantom key-up filtering)
@@ -1205,6 +1242,7 @@ extern	centity_t		cg_entities[MAX_GENTITIES];
 extern	weaponInfo_t	cg_weapons[MAX_WEAPONS];
 extern	itemInfo_t		cg_items[MAX_ITEMS];
 extern	markPoly_t		cg_markPolys[MAX_MARK_POLYS];
+extern	predictFrame_t	cg_predictFrame;
 
 #define EXTERN_CG_CVAR
 	#include "cg_cvar.h"
@@ -1362,12 +1400,21 @@ sfxHandle_t	CG_CustomSound( int clientNum, const char *soundName );
 // cg_predict.c
 //
 void CG_BuildSolidList( void );
+qboolean CG_MoverInBox( const vec3_t mins, const vec3_t maxs );
 int	CG_PointContents( const vec3_t point, int passEntityNum );
 void CG_Trace( trace_t *result, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end, 
 					 int skipNumber, int mask );
 void CG_PredictPlayerState( void );
 void CG_LoadDeferredPlayers( void );
 
+//
+// cg_predictstats.c
+//
+void CG_PredictStatsReset( void );
+void CG_PredictStatsEndFrame( void );
+void CG_DrawPredictStats( void );
+void CG_PredictStats_f( void );
+
 void CG_PlayDroppedEvents( playerState_t *ps, playerState_t *ops );
 
 //
@@ -1430,12 +1477,21 @@ void	CG_ImpactMark( qhandle_t markShader,
 					qboolean alphaFade, 
 					float radius, qboolean temporary );
 
+//
+// cg_polys.c
+//
+void	CG_ClearPolys( void );
+void	CG_FlushPolys( void );
+void	CG_AddPolyToScene( qhandle_t shader, int numVerts, const polyVert_t *verts );
+
 //
 // cg_localents.c
 //
 void	CG_InitLocalEntities( void );
 localEntity_t	*CG_AllocLocalEntity( void );
+void	CG_PredictBloodImpact( localEntity_t *le );
 void	CG_AddLocalEntities( void );
+void	CG_LocalEntityStats_f( void );
 
 //
 // cg_effects.c
@@ -1505,6 +1561,7 @@ void Menu_Reset( void );
 // cg_servercmds.c
 //
 void CG_ExecuteNewServerCommands( int latestSequence );
+void CG_RequestScores( void );
 void CG_ParseServerinfo( void );
 void CG_ParseSysteminfo( void );
 void CG_SetConfigValues( void );
@@ -11,6 +11,37 @@ localEntity_t	cg_localEntities[MAX_LOCAL_ENTITIES];
 localEntity_t	cg_activeLocalEntities;		// double linked list
 localEntity_t	*cg_freeLocalEntities;		// single linked list
 
+// when the pool is full the oldest entity of the least important class
+// present is evicted, so a rail spiral eats smoke instead of score plums
+typedef enum {
+	LEP_COSMETIC,		// smoke, trails, blood, brass
+	LEP_EFFECT,			// explosions, rings, gibs
+	LEP_GAMEPLAY,		// score and damage plums, powerup effects
+
+	LEP_NUM_CLASSES
+} lePriority_t;
+
+static const char *lePriorityNames[LEP_NUM_CLASSES] = {
+	"cosmetic",
+	"effect",
+	"gameplay"
+};
+
+typedef struct {
+	int		allocs;
+	int		evictions[LEP_NUM_CLASSES];
+	int		active[LEP_NUM_CLASSES];
+} leCounters_t;
+
+static leCounters_t	leFrame;		// being counted
+static leCounters_t	leLastFrame;	// complete, shown by "localents"
+static leCounters_t	leTotal;		// since the last CG_InitLocalEntities
+static int			lePeakAllocs;
+
+// next entity of the CG_AddLocalEntities walk, an effect spawning
+// another one can evict it from under the loop
+static localEntity_t	*leWalkNext;
+
 /*
 ===================
 CG_InitLocalEntities
@@ -28,6 +59,11 @@ void	CG_InitLocalEntities( void ) {
 	for ( i = 0 ; i < MAX_LOCAL_ENTITIES - 1 ; i++ ) {
 		cg_localEntities[i].next = &cg_localEntities[i+1];
 	}
+
+	memset( &leFrame, 0, sizeof( leFrame ) );
+	memset( &leLastFrame, 0, sizeof( leLastFrame ) );
+	memset( &leTotal, 0, sizeof( leTotal ) );
+	lePeakAllocs = 0;
 }
 
 
@@ -41,6 +77,10 @@ void CG_FreeLocalEntity( localEntity_t *le ) {
 		CG_Error( "CG_FreeLocalEntity: not active" );
 	}
 
+	if ( le == leWalkNext ) {
+		leWalkNext = le->prev;
+	}
+
 	// remove from the doubly linked active list
 	le->prev->next = le->next;
 	le->next->prev = le->prev;
@@ -50,6 +90,73 @@ void CG_FreeLocalEntity( localEntity_t *le ) {
 	cg_freeLocalEntities = le;
 }
 
+/*
+===================
+CG_LocalEntityPriority
+===================
+*/
+static lePriority_t CG_LocalEntityPriority( const localEntity_t *le ) {
+	switch ( le->leType ) {
+	case LE_MOVE_SCALE_FADE:
+	case LE_FALL_SCALE_FADE:
+	case LE_SCALE_FADE:
+	case LE_BLOOD_PARTICLE:
+		return LEP_COSMETIC;
+
+	case LE_FRAGMENT:
+		return le->leBounceSoundType == LEBS_BRASS ? LEP_COSMETIC : LEP_EFFECT;
+
+	case LE_SCOREPLUM:
+	case LE_DAMAGEPLUM:
+#ifdef MISSIONPACK
+	case LE_KAMIKAZE:
+	case LE_INVULIMPACT:
+	case LE_INVULJUICED:
+#endif
+		return LEP_GAMEPLAY;
+
+	default:
+		return LEP_EFFECT;
+	}
+}
+
+
+/*
+===================
+CG_EvictLocalEntity
+
+Frees the oldest entity of the lowest priority class in use
+===================
+*/
+static void CG_EvictLocalEntity( void ) {
+	localEntity_t	*le, *oldest[LEP_NUM_CLASSES];
+	lePriority_t	pri;
+	int				i;
+
+	memset( oldest, 0, sizeof( oldest ) );
+
+	// walk from the oldest, there is almost always cosmetic stuff near the end
+	for ( le = cg_activeLocalEntities.prev ; le != &cg_activeLocalEntities ; le = le->prev ) {
+		pri = CG_LocalEntityPriority( le );
+		if ( !oldest[ pri ] ) {
+			oldest[ pri ] = le;
+			if ( pri == LEP_COSMETIC ) {
+				break;
+			}
+		}
+	}
+
+	for ( i = 0 ; i < LEP_NUM_CLASSES ; i++ ) {
+		if ( oldest[ i ] ) {
+			leFrame.evictions[ i ]++;
+			leTotal.evictions[ i ]++;
+			CG_FreeLocalEntity( oldest[ i ] );
+			return;
+		}
+	}
+}
+
+
 /*
 ===================
 CG_AllocLocalEntity
@@ -61,11 +168,12 @@ localEntity_t	*CG_AllocLocalEntity( void ) {
 	localEntity_t	*le;
 
 	if ( !cg_freeLocalEntities ) {
-		// no free entities, so free the one at the end of the chain
-		// remove the oldest active entity
-		CG_FreeLocalEntity( cg_activeLocalEntities.prev );
+		CG_EvictLocalEntity();
 	}
 
+	leFrame.allocs++;
+	leTotal.allocs++;
+
 	le = cg_freeLocalEntities;
 	cg_freeLocalEntities = cg_freeLocalEntities->next;
 
@@ -444,7 +552,7 @@ static void CG_EmitPolyVerts( const refEntity_t *re )
 		verts[i].modulate[3] = re->shaderRGBA.rgba[3];
 	}
 
-	trap_R_AddPolyToScene( re->customShader, 4, verts );
+	CG_AddPolyToScene( re->customShader, 4, verts );
 }
 
 
@@ -1005,12 +1113,66 @@ void CG_AddDamagePlum( localEntity_t *le ) {
 }
 
 
+/*
+===================
+CG_PredictBloodImpact
+
+Traces the gravity arc of a new blood droplet in a few chords and
+remembers where it ends: against the world and anything solid that
+stands still, or in water. Only movers need checking while it flies.
+===================
+*/
+#define	BLOOD_PREDICT_SEGMENTS	4
+#define	BLOOD_FLIGHT_PAD		16		// chord sag plus some slack
+
+void CG_PredictBloodImpact( localEntity_t *le ) {
+	trace_t		trace;
+	vec3_t		start, end;
+	int			i, t0, t1;
+
+	le->impactTime = 0;
+
+	VectorCopy( le->pos.trBase, start );
+	ClearBounds( le->flightMins, le->flightMaxs );
+	AddPointToBounds( start, le->flightMins, le->flightMaxs );
+
+	t0 = le->startTime;
+	for ( i = 1 ; i <= BLOOD_PREDICT_SEGMENTS ; i++ ) {
+		t1 = le->startTime + ( le->endTime - le->startTime ) * i / BLOOD_PREDICT_SEGMENTS;
+		BG_EvaluateTrajectory( &le->pos, t1, end );
+
+		CG_Trace( &trace, start, NULL, NULL, end, -1, CONTENTS_SOLID | MASK_WATER );
+		AddPointToBounds( trace.endpos, le->flightMins, le->flightMaxs );
+
+		if ( trace.fraction < 1.0f ) {
+			// never in the frame it was spawned
+			le->impactTime = t0 + ( t1 - t0 ) * trace.fraction;
+			if ( le->impactTime <= le->startTime ) {
+				le->impactTime = le->startTime + 1;
+			}
+			VectorCopy( trace.endpos, le->impactPoint );
+			VectorCopy( trace.plane.normal, le->impactNormal );
+			le->impactWater = ( trace.contents & MASK_WATER ) ? qtrue : qfalse;
+			break;
+		}
+
+		VectorCopy( end, start );
+		t0 = t1;
+	}
+
+	for ( i = 0 ; i < 3 ; i++ ) {
+		le->flightMins[i] -= BLOOD_FLIGHT_PAD;
+		le->flightMaxs[i] += BLOOD_FLIGHT_PAD;
+	}
+}
+
+
 /*
 ===================
 CG_AddBloodParticle
 
-Blood droplet that moves with gravity, traces for collision,
-leaves a blood mark on impact, then fades out on the surface.
+Blood droplet that moves with gravity, leaves a blood mark at the
+predicted impact or a sinking cloud where it enters water.
 ===================
 */
 static void CG_AddBloodParticle( localEntity_t *le ) {
@@ -1026,37 +1188,44 @@ static void CG_AddBloodParticle( localEntity_t *le ) {
 	if ( c < 0 ) c = 0;
 	re->shaderRGBA.rgba[3] = 0xff * c * le->color[3];
 
-	// Calculate new position
-	BG_EvaluateTrajectory( &le->pos, cg.time, newOrigin );
-
-	// Particle entered water - spawn sinking blood cloud
-	if ( CG_PointContents( newOrigin, -1 ) & MASK_WATER ) {
-		localEntity_t *cloud;
-
-		cloud = CG_SmokePuff( newOrigin, vec3_origin,
-			1 + random() * 2, 1, 1, 1, 0.4f,
-			300 + random() * 200, cg.time, 0, 0,
-			cgs.media.bloodTrailShader );
-		cloud->leType = LE_FALL_SCALE_FADE;
-		cloud->pos.trDelta[2] = 5 + random() * 10;
+	if ( le->impactTime && cg.time >= le->impactTime ) {
+		if ( le->impactWater ) {
+			// Particle entered water - spawn sinking blood cloud
+			localEntity_t *cloud;
+
+			cloud = CG_SmokePuff( le->impactPoint, vec3_origin,
+				1 + random() * 2, 1, 1, 1, 0.4f,
+				300 + random() * 200, cg.time, 0, 0,
+				cgs.media.bloodTrailShader );
+			cloud->leType = LE_FALL_SCALE_FADE;
+			cloud->pos.trDelta[2] = 5 + random() * 10;
+		} else {
+			// Hit a surface - leave a matching mark
+			CG_ImpactMark( cgs.media.bloodMarkShader, le->impactPoint, le->impactNormal,
+				random() * 360, 1, 1, 1, 1, qtrue, le->radius, qfalse );
+		}
 		CG_FreeLocalEntity( le );
 		return;
 	}
 
-	// Trace for collision
-	CG_Trace( &trace, re->origin, NULL, NULL, newOrigin, -1, CONTENTS_SOLID );
+	// Calculate new position
+	BG_EvaluateTrajectory( &le->pos, cg.time, newOrigin );
+
+	// a door or platform may have moved into the path
+	if ( CG_MoverInBox( le->flightMins, le->flightMaxs ) ) {
+		CG_Trace( &trace, re->origin, NULL, NULL, newOrigin, -1, CONTENTS_SOLID );
 
-	if ( trace.fraction < 1.0f ) {
-		// Hit a surface - leave a matching mark
-		CG_ImpactMark( cgs.media.bloodMarkShader, trace.endpos, trace.plane.normal,
-			random() * 360, 1, 1, 1, 1, qtrue, le->radius, qfalse );
-		CG_FreeLocalEntity( le );
-		return;
-	} else {
-		// Still in flight
-		VectorCopy( newOrigin, re->origin );
+		if ( trace.fraction < 1.0f ) {
+			CG_ImpactMark( cgs.media.bloodMarkShader, trace.endpos, trace.plane.normal,
+				random() * 360, 1, 1, 1, 1, qtrue, le->radius, qfalse );
+			CG_FreeLocalEntity( le );
+			return;
+		}
 	}
 
+	// Still in flight
+	VectorCopy( newOrigin, re->origin );
+
 	trap_R_AddRefEntityToScene( re );
 }
 
@@ -1070,20 +1239,24 @@ CG_AddLocalEntities
 ===================
 */
 void CG_AddLocalEntities( void ) {
-	localEntity_t	*le, *next;
+	localEntity_t	*le;
+
+	memset( leFrame.active, 0, sizeof( leFrame.active ) );
 
 	// walk the list backwards, so any new local entities generated
 	// (trails, marks, etc) will be present this frame
 	le = cg_activeLocalEntities.prev;
-	for ( ; le != &cg_activeLocalEntities ; le = next ) {
+	for ( ; le != &cg_activeLocalEntities ; le = leWalkNext ) {
 		// grab next now, so if the local entity is freed we
 		// still have it
-		next = le->prev;
+		leWalkNext = le->prev;
 
 		if ( cg.time >= le->endTime ) {
 			CG_FreeLocalEntity( le );
 			continue;
 		}
+		leFrame.active[ CG_LocalEntityPriority( le ) ]++;
+
 		switch ( le->leType ) {
 		default:
 			CG_Error( "Bad leType: %i", le->leType );
@@ -1148,6 +1321,39 @@ void CG_AddLocalEntities( void ) {
 			break;
 		}
 	}
+
+	leWalkNext = NULL;
+
+	if ( leFrame.allocs > lePeakAllocs ) {
+		lePeakAllocs = leFrame.allocs;
+	}
+	leLastFrame = leFrame;
+	memset( &leFrame, 0, sizeof( leFrame ) );
+}
+
+
+/*
+===================
+CG_LocalEntityStats_f
+
+Prints pool usage, allocations and evictions of the last frame
+===================
+*/
+void CG_LocalEntityStats_f( void ) {
+	int		i, active;
+
+	active = 0;
+	for ( i = 0 ; i < LEP_NUM_CLASSES ; i++ ) {
+		active += leLastFrame.active[ i ];
+	}
+
+	CG_Printf( "local entities: %i of %i active, %i allocs last frame, peak %i, %i total\n",
+		active, MAX_LOCAL_ENTITIES, leLastFrame.allocs, lePeakAllocs, leTotal.allocs );
+	CG_Printf( "%-10s %8s %12s %12s\n", "class", "active", "evicted/frm", "evicted" );
+	for ( i = 0 ; i < LEP_NUM_CLASSES ; i++ ) {
+		CG_Printf( "%-10s %8i %12i %12i\n", lePriorityNames[ i ], leLastFrame.active[ i ],
+			leLastFrame.evictions[ i ], leTotal.evictions[ i ] );
+	}
 }
 
 
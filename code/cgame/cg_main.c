@@ -883,6 +883,9 @@ static void CG_RegisterGraphics( void ) {
 		for ( j = 0 ; j < 3 ; j++ ) {
 			cgs.inlineModelMidpoints[i][j] = mins[j] + 0.5 * ( maxs[j] - mins[j] );
 		}
+		VectorCopy( mins, cgs.inlineModelMins[i] );
+		VectorCopy( maxs, cgs.inlineModelMaxs[i] );
+		cgs.inlineModelRadius[i] = RadiusFromBounds( mins, maxs );
 	}
 
 	// register all the server specified models
@@ -18,6 +18,23 @@ markPoly_t	*cg_freeMarkPolys;			// single linked list
 markPoly_t	cg_markPolys[MAX_MARK_POLYS];
 static		int	markTotal;
 
+// marks are hashed by the coarse cell of their impact point, so a new
+// impact can find an existing mark on the same spot and refresh it
+// instead of stacking polys
+#define	MARK_HASH_SIZE		256		// must be a power of two
+#define	MARK_HASH_CELL		64
+#define	MARK_MERGE_FRAC		0.5f	// of the radius
+#define	MARK_MERGE_DOT		0.9f
+
+static markPoly_t	*markHash[MARK_HASH_SIZE];
+static int			markImpacts;
+
+// vertex budget buckets by view distance
+#define	MARK_DIST_BANDS		32
+#define	MARK_DIST_BAND		128
+
+static int			markBand[MAX_MARK_POLYS];	// distance band this frame
+
 /*
 ===================
 CG_InitMarkPolys
@@ -29,6 +46,8 @@ void	CG_InitMarkPolys( void ) {
 	int		i;
 
 	memset( cg_markPolys, 0, sizeof(cg_markPolys) );
+	memset( markHash, 0, sizeof( markHash ) );
+	markImpacts = 0;
 
 	cg_activeMarkPolys.nextMark = &cg_activeMarkPolys;
 	cg_activeMarkPolys.prevMark = &cg_activeMarkPolys;
@@ -49,6 +68,14 @@ void CG_FreeMarkPoly( markPoly_t *le ) {
 		CG_Error( "CG_FreeLocalEntity: not active" );
 	}
 
+	if ( le->hashPrev ) {
+		*le->hashPrev = le->hashNext;
+		if ( le->hashNext ) {
+			le->hashNext->hashPrev = le->hashPrev;
+		}
+		le->hashPrev = NULL;
+	}
+
 	// remove from the doubly linked active list
 	le->prevMark->nextMark = le->nextMark;
 	le->nextMark->prevMark = le->prevMark;
@@ -93,6 +120,141 @@ markPoly_t	*CG_AllocMark( void ) {
 
 
 
+/*
+===================
+CG_MarkHash
+===================
+*/
+static int CG_MarkHash( int x, int y, int z ) {
+	unsigned	h;
+
+	h = (unsigned)x * 73856093u ^ (unsigned)y * 19349663u ^ (unsigned)z * 83492791u;
+	return h & ( MARK_HASH_SIZE - 1 );
+}
+
+
+/*
+===================
+CG_LinkMark
+===================
+*/
+static void CG_LinkMark( markPoly_t *mp ) {
+	markPoly_t	**head;
+
+	head = &markHash[ CG_MarkHash( floor( mp->origin[0] / MARK_HASH_CELL ),
+		floor( mp->origin[1] / MARK_HASH_CELL ), floor( mp->origin[2] / MARK_HASH_CELL ) ) ];
+
+	mp->hashNext = *head;
+	mp->hashPrev = head;
+	if ( *head ) {
+		(*head)->hashPrev = &mp->hashNext;
+	}
+	*head = mp;
+}
+
+
+/*
+===================
+CG_FindMark
+
+Returns a mark of the same shader and color that a new impact would
+cover, if any
+===================
+*/
+static markPoly_t *CG_FindMark( qhandle_t markShader, const vec3_t origin, const vec3_t dir,
+							   float radius, const vec4_t color, qboolean alphaFade ) {
+	markPoly_t	*mp;
+	vec3_t		delta;
+	float		dist;
+	int			mins[3], maxs[3];
+	int			i, x, y, z;
+
+	dist = radius * MARK_MERGE_FRAC;
+	for ( i = 0 ; i < 3 ; i++ ) {
+		mins[i] = floor( ( origin[i] - dist ) / MARK_HASH_CELL );
+		maxs[i] = floor( ( origin[i] + dist ) / MARK_HASH_CELL );
+	}
+
+	for ( x = mins[0] ; x <= maxs[0] ; x++ ) {
+		for ( y = mins[1] ; y <= maxs[1] ; y++ ) {
+			for ( z = mins[2] ; z <= maxs[2] ; z++ ) {
+				for ( mp = markHash[ CG_MarkHash( x, y, z ) ] ; mp ; mp = mp->hashNext ) {
+					if ( mp->markShader != markShader || mp->alphaFade != alphaFade ) {
+						continue;
+					}
+					if ( mp->color[0] != color[0] || mp->color[1] != color[1]
+						|| mp->color[2] != color[2] || mp->color[3] != color[3] ) {
+						continue;
+					}
+					if ( fabs( mp->radius - radius ) > dist ) {
+						continue;
+					}
+					if ( DotProduct( mp->normal, dir ) < MARK_MERGE_DOT ) {
+						continue;
+					}
+					VectorSubtract( mp->origin, origin, delta );
+					if ( DotProduct( delta, delta ) > dist * dist ) {
+						continue;
+					}
+					return mp;
+				}
+			}
+		}
+	}
+
+	return NULL;
+}
+
+
+/*
+===================
+CG_RefreshMark
+
+Restarts the lifetime of every poly of the impact mp belongs to. They are
+adjacent in the active list and move to its head together, so the list
+stays in time order for CG_AllocMark.
+===================
+*/
+static void CG_RefreshMark( markPoly_t *mp ) {
+	markPoly_t	*first, *last;
+	byte		colors[4];
+	int			j;
+
+	first = last = mp;
+	while ( first->prevMark != &cg_activeMarkPolys && first->prevMark->impact == mp->impact ) {
+		first = first->prevMark;
+	}
+	while ( last->nextMark != &cg_activeMarkPolys && last->nextMark->impact == mp->impact ) {
+		last = last->nextMark;
+	}
+
+	if ( first != cg_activeMarkPolys.nextMark ) {
+		first->prevMark->nextMark = last->nextMark;
+		last->nextMark->prevMark = first->prevMark;
+
+		first->prevMark = &cg_activeMarkPolys;
+		last->nextMark = cg_activeMarkPolys.nextMark;
+		cg_activeMarkPolys.nextMark->prevMark = last;
+		cg_activeMarkPolys.nextMark = first;
+	}
+
+	// undo any fading
+	for ( mp = first ; ; mp = mp->nextMark ) {
+		mp->time = cg.time;
+		colors[0] = mp->color[0] * 255;
+		colors[1] = mp->color[1] * 255;
+		colors[2] = mp->color[2] * 255;
+		colors[3] = mp->color[3] * 255;
+		for ( j = 0 ; j < mp->poly.numVerts ; j++ ) {
+			*(int *)mp->verts[j].modulate = *(int *)colors;
+		}
+		if ( mp == last ) {
+			break;
+		}
+	}
+}
+
+
 /*
 =================
 CG_ImpactMark
@@ -102,6 +264,8 @@ dir should be the plane normal
 
 temporary marks will not be stored or randomly oriented, but immediately
 passed to the renderer.
+
+a persistent mark landing on a matching one refreshes that mark instead
 =================
 */
 #define	MAX_MARK_FRAGMENTS	128
@@ -119,6 +283,8 @@ void CG_ImpactMark( qhandle_t markShader, const vec3_t origin, const vec3_t dir,
 	markFragment_t	markFragments[MAX_MARK_FRAGMENTS], *mf;
 	vec3_t			markPoints[MAX_MARK_POINTS];
 	vec3_t			projection;
+	vec4_t			color;
+	markPoly_t		*mark;
 
 	if ( !cg_addMarks.integer && !temporary ) {
 		return;
@@ -128,12 +294,20 @@ void CG_ImpactMark( qhandle_t markShader, const vec3_t origin, const vec3_t dir,
 		CG_Error( "CG_ImpactMark called with <= 0 radius" );
 	}
 
-	//if ( markTotal >= MAX_MARK_POLYS ) {
-	//	return;
-	//}
-
 	// create the texture axis
 	VectorNormalize2( dir, axis[0] );
+
+	if ( !temporary ) {
+		VectorSet( color, red, green, blue );
+		color[3] = alpha;
+		mark = CG_FindMark( markShader, origin, axis[0], radius, color, alphaFade );
+		if ( mark ) {
+			CG_RefreshMark( mark );
+			return;
+		}
+		markImpacts++;
+	}
+
 	PerpendicularVector( axis[1], axis[0] );
 	RotatePointAroundVector( axis[2], axis[0], axis[1], orientation );
 	CrossProduct( axis[0], axis[2], axis[1] );
@@ -162,7 +336,6 @@ void CG_ImpactMark( qhandle_t markShader, const vec3_t origin, const vec3_t dir,
 	for ( i = 0, mf = markFragments ; i < numFragments ; i++, mf++ ) {
 		polyVert_t	*v;
 		polyVert_t	verts[MAX_VERTS_ON_POLY];
-		markPoly_t	*mark;
 
 		// we have an upper limit on the complexity of polygons
 		// that we store persistantly
@@ -182,13 +355,18 @@ void CG_ImpactMark( qhandle_t markShader, const vec3_t origin, const vec3_t dir,
 
 		// if it is a temporary (shadow) mark, add it immediately and forget about it
 		if ( temporary ) {
-			trap_R_AddPolyToScene( markShader, mf->numPoints, verts );
+			CG_AddPolyToScene( markShader, mf->numPoints, verts );
 			continue;
 		}
 
 		// otherwise save it persistantly
 		mark = CG_AllocMark();
 		mark->time = cg.time;
+		mark->impact = markImpacts;
+		VectorCopy( origin, mark->origin );
+		VectorCopy( axis[0], mark->normal );
+		mark->radius = radius;
+		CG_LinkMark( mark );
 		mark->alphaFade = alphaFade;
 		mark->markShader = markShader;
 		mark->poly.numVerts = mf->numPoints;
@@ -205,6 +383,10 @@ void CG_ImpactMark( qhandle_t markShader, const vec3_t origin, const vec3_t dir,
 /*
 ===============
 CG_AddMarks
+
+When the marks have more than cg_markBudget verts the farthest from the
+view are dropped for this frame. Marks behind the view are kept, mirrors
+and portals draw the same polys.
 ===============
 */
 #define	MARK_TOTAL_TIME		10000
@@ -215,11 +397,17 @@ void CG_AddMarks( void ) {
 	markPoly_t	*mp, *next;
 	int			t;
 	int			fade;
+	int			band, lastBand, budget;
+	int			bandVerts[MARK_DIST_BANDS];
+	vec3_t		delta;
+	float		dist;
 
 	if ( !cg_addMarks.integer ) {
 		return;
 	}
 
+	memset( bandVerts, 0, sizeof( bandVerts ) );
+
 	mp = cg_activeMarkPolys.nextMark;
 	for ( ; mp != &cg_activeMarkPolys ; mp = next ) {
 		// grab next now, so if the local entity is freed we
@@ -232,6 +420,42 @@ void CG_AddMarks( void ) {
 			continue;
 		}
 
+		VectorSubtract( mp->origin, cg.refdef.vieworg, delta );
+		dist = VectorLength( delta );
+		band = dist / MARK_DIST_BAND;
+		if ( band >= MARK_DIST_BANDS ) {
+			band = MARK_DIST_BANDS - 1;
+		}
+		markBand[ mp - cg_markPolys ] = band;
+		bandVerts[ band ] += mp->poly.numVerts;
+	}
+
+	// find the farthest band that still fits, the one crossing the
+	// budget is filled newest first
+	lastBand = MARK_DIST_BANDS - 1;
+	budget = cg_markBudget.integer;
+	if ( budget > 0 ) {
+		for ( band = 0 ; band < MARK_DIST_BANDS ; band++ ) {
+			if ( bandVerts[ band ] > budget ) {
+				lastBand = band;
+				break;
+			}
+			budget -= bandVerts[ band ];
+		}
+	}
+
+	for ( mp = cg_activeMarkPolys.nextMark ; mp != &cg_activeMarkPolys ; mp = mp->nextMark ) {
+		band = markBand[ mp - cg_markPolys ];
+		if ( band > lastBand ) {
+			continue;
+		}
+		if ( band == lastBand && cg_markBudget.integer > 0 ) {
+			if ( mp->poly.numVerts > budget ) {
+				continue;
+			}
+			budget -= mp->poly.numVerts;
+		}
+
 		// fade out the energy bursts
 		if ( mp->markShader == cgs.media.energyMarkShader ) {
 
@@ -268,7 +492,7 @@ void CG_AddMarks( void ) {
 		}
 
 
-		trap_R_AddPolyToScene( mp->markShader, mp->poly.numVerts, mp->verts );
+		CG_AddPolyToScene( mp->markShader, mp->poly.numVerts, mp->verts );
 	}
 }
 
@@ -280,8 +504,6 @@ void CG_AddMarks( void ) {
 
 typedef struct particle_s
 {
-	struct particle_s	*next;
-
 	int			time;
 	int			endtime;
 
@@ -356,11 +578,39 @@ static int	numShaderAnims;
 // done.
 
 #define		PARTICLE_GRAVITY	40
-#define		MAX_PARTICLES	1024
+#define		MAX_PARTICLES	4096
 
-cparticle_t	*active_particles, *free_particles;
+// spawn functions fill in a cparticle_t slot, the fields the per-frame
+// update needs are then mirrored into dense arrays kept in spawn order
+// so the update is a straight loop over contiguous floats
 cparticle_t	particles[MAX_PARTICLES];
-const int	cl_numparticles = MAX_PARTICLES;
+static int	freeParticles[MAX_PARTICLES];
+static int	numFreeParticles;
+
+#define	PEXPIRE_NEVER		0
+#define	PEXPIRE_ENDTIME		1	// removed once cg.time passes endtime
+#define	PEXPIRE_ONCE		2	// temporary sprite, drawn for one frame
+
+typedef struct {
+	int		slot[MAX_PARTICLES];		// index into particles[]
+	int		expire[MAX_PARTICLES];
+	int		time[MAX_PARTICLES];
+	int		endtime[MAX_PARTICLES];
+	float	alpha[MAX_PARTICLES];
+	float	alphavel[MAX_PARTICLES];
+	float	org[3][MAX_PARTICLES];
+	float	vel[3][MAX_PARTICLES];
+	float	accel[3][MAX_PARTICLES];
+
+	// written by CG_UpdateParticles
+	float	fade[MAX_PARTICLES];
+	float	pos[3][MAX_PARTICLES];
+	int		dead[MAX_PARTICLES];
+} particleArrays_t;
+
+static particleArrays_t	pa;
+static int				numParticles;			// oldest first
+static int				numSyncedParticles;		// the rest were spawned since the last update
 
 qboolean	initparticles = qfalse;
 vec3_t		pvforward, pvright, pvup;
@@ -377,17 +627,15 @@ void CG_ClearParticles (void)
 {
 	int		i;
 
-	memset( particles, 0, sizeof(particles) );
-
-	free_particles = &particles[0];
-	active_particles = NULL;
+	numParticles = 0;
+	numSyncedParticles = 0;
 
-	for (i=0 ;i<cl_numparticles ; i++)
+	// hand out the low slots first
+	for (i=0 ; i<MAX_PARTICLES ; i++)
 	{
-		particles[i].next = &particles[i+1];
-		particles[i].type = 0;
+		freeParticles[i] = MAX_PARTICLES - 1 - i;
 	}
-	particles[cl_numparticles-1].next = NULL;
+	numFreeParticles = MAX_PARTICLES;
 
 	oldtime = cg.time;
 
@@ -406,6 +654,135 @@ void CG_ClearParticles (void)
 }
 
 
+/*
+===============
+CG_AllocParticle
+
+Returns a cleared slot appended to the active particles,
+or NULL when all of them are in use
+===============
+*/
+static cparticle_t *CG_AllocParticle (void)
+{
+	cparticle_t	*p;
+	int			slot;
+
+	if (!numFreeParticles)
+		return NULL;
+
+	slot = freeParticles[--numFreeParticles];
+	p = &particles[slot];
+	memset( p, 0, sizeof( *p ) );
+
+	pa.slot[numParticles++] = slot;
+
+	return p;
+}
+
+
+/*
+===============
+CG_SyncParticle
+
+Mirrors the fields of the particle at dense index i, needed
+after anything changes them on the cparticle_t
+===============
+*/
+static void CG_SyncParticle (int i)
+{
+	cparticle_t	*p;
+	int			j;
+
+	p = &particles[ pa.slot[i] ];
+
+	switch ( p->type ) {
+	case P_SMOKE:
+	case P_ANIM:
+	case P_BLEED:
+	case P_SMOKE_IMPACT:
+	case P_WEATHER_FLURRY:
+	case P_FLAT_SCALEUP_FADE:
+		pa.expire[i] = PEXPIRE_ENDTIME;
+		break;
+	case P_BAT:
+	case P_SPRITE:
+		pa.expire[i] = p->endtime < 0 ? PEXPIRE_ONCE : PEXPIRE_NEVER;
+		break;
+	default:
+		pa.expire[i] = PEXPIRE_NEVER;
+		break;
+	}
+
+	pa.time[i] = p->time;
+	pa.endtime[i] = p->endtime;
+	pa.alpha[i] = p->alpha;
+	pa.alphavel[i] = p->alphavel;
+	for ( j = 0; j < 3; j++ ) {
+		pa.org[j][i] = p->org[j];
+		pa.vel[j][i] = p->vel[j];
+		pa.accel[j][i] = p->accel[j];
+	}
+}
+
+
+/*
+===============
+CG_MoveParticle
+===============
+*/
+static void CG_MoveParticle (int to, int from)
+{
+	int		j;
+
+	pa.slot[to] = pa.slot[from];
+	pa.expire[to] = pa.expire[from];
+	pa.time[to] = pa.time[from];
+	pa.endtime[to] = pa.endtime[from];
+	pa.alpha[to] = pa.alpha[from];
+	pa.alphavel[to] = pa.alphavel[from];
+	for ( j = 0; j < 3; j++ ) {
+		pa.org[j][to] = pa.org[j][from];
+		pa.vel[j][to] = pa.vel[j][from];
+		pa.accel[j][to] = pa.accel[j][from];
+	}
+}
+
+
+/*
+===============
+CG_UpdateParticles
+
+Fade, expiry and trajectory for every particle. There are no
+per-type branches, and the fixed size blocks let native compilers
+turn the inner loop into SIMD code at -O2. The padding past count
+only touches unused array entries.
+===============
+*/
+#define	PARTICLE_BLOCK		4	// MAX_PARTICLES must be a multiple of this
+
+static void CG_UpdateParticles (int count, int now)
+{
+	float	time, time2;
+	int		i, block;
+
+	count = ( count + PARTICLE_BLOCK - 1 ) & ~( PARTICLE_BLOCK - 1 );
+
+	for ( block = 0; block < count; block += PARTICLE_BLOCK )
+	for ( i = block; i < block + PARTICLE_BLOCK; i++ )
+	{
+		time = (now - pa.time[i])*0.001;
+		time2 = time*time;
+
+		pa.fade[i] = pa.alpha[i] + time*pa.alphavel[i];
+		pa.dead[i] = ( pa.fade[i] <= 0 ) | ( ( pa.expire[i] == PEXPIRE_ENDTIME ) & ( now > pa.endtime[i] ) );
+
+		pa.pos[0][i] = pa.org[0][i] + pa.vel[0][i]*time + pa.accel[0][i]*time2;
+		pa.pos[1][i] = pa.org[1][i] + pa.vel[1][i]*time + pa.accel[1][i]*time2;
+		pa.pos[2][i] = pa.org[2][i] + pa.vel[2][i]*time + pa.accel[2][i]*time2;
+	}
+}
+
+
 /*
 =====================
 CG_AddParticleToScene
@@ -1048,9 +1425,9 @@ void CG_AddParticleToScene (cparticle_t *p, vec3_t org, float alpha)
 	}
 
 	if (p->type == P_WEATHER || p->type == P_WEATHER_TURBULENT || p->type == P_WEATHER_FLURRY)
-		trap_R_AddPolyToScene( p->pshader, 3, TRIverts );
+		CG_AddPolyToScene( p->pshader, 3, TRIverts );
 	else
-		trap_R_AddPolyToScene( p->pshader, 4, verts );
+		CG_AddPolyToScene( p->pshader, 4, verts );
 
 }
 
@@ -1064,14 +1441,11 @@ CG_AddParticles
 */
 void CG_AddParticles (void)
 {
-	cparticle_t		*p, *next;
+	cparticle_t		*p;
 	float			alpha;
-	float			time, time2;
 	vec3_t			org;
-	//int				color;
-	cparticle_t		*active, *tail;
-	//int				type;
 	vec3_t			rotate_ang;
+	int				i, n;
 
 	if (!initparticles)
 		CG_ClearParticles ();
@@ -1087,108 +1461,58 @@ void CG_AddParticles (void)
 	
 	oldtime = cg.time;
 
-	active = NULL;
-	tail = NULL;
-
-	for (p=active_particles ; p ; p=next)
-	{
-
-		next = p->next;
+	// pick up everything spawned since the last frame
+	for (i = numSyncedParticles ; i < numParticles ; i++)
+		CG_SyncParticle (i);
 
-		time = (cg.time - p->time)*0.001;
+	CG_UpdateParticles (numParticles, cg.time);
 
-		alpha = p->alpha + time*p->alphavel;
-		if (alpha <= 0)
-		{	// faded out
-			p->next = free_particles;
-			free_particles = p;
-			p->type = 0;
-			p->color = 0;
-			p->alpha = 0;
+	// newest first, the order the particles were always drawn in
+	for (i = numParticles - 1 ; i >= 0 ; i--)
+	{
+		if (pa.dead[i])
 			continue;
-		}
-
-		if (p->type == P_SMOKE || p->type == P_ANIM || p->type == P_BLEED || p->type == P_SMOKE_IMPACT)
-		{
-			if (cg.time > p->endtime)
-			{
-				p->next = free_particles;
-				free_particles = p;
-				p->type = 0;
-				p->color = 0;
-				p->alpha = 0;
-			
-				continue;
-			}
-
-		}
-
-		if (p->type == P_WEATHER_FLURRY)
-		{
-			if (cg.time > p->endtime)
-			{
-				p->next = free_particles;
-				free_particles = p;
-				p->type = 0;
-				p->color = 0;
-				p->alpha = 0;
-			
-				continue;
-			}
-		}
-
-
-		if (p->type == P_FLAT_SCALEUP_FADE)
-		{
-			if (cg.time > p->endtime)
-			{
-				p->next = free_particles;
-				free_particles = p;
-				p->type = 0;
-				p->color = 0;
-				p->alpha = 0;
-				continue;
-			}
 
-		}
+		p = &particles[ pa.slot[i] ];
 
-		if ((p->type == P_BAT || p->type == P_SPRITE) && p->endtime < 0) {
+		if (pa.expire[i] == PEXPIRE_ONCE) {
 			// temporary sprite
-			CG_AddParticleToScene (p, p->org, alpha);
-			p->next = free_particles;
-			free_particles = p;
-			p->type = 0;
-			p->color = 0;
-			p->alpha = 0;
+			CG_AddParticleToScene (p, p->org, pa.fade[i]);
+			pa.dead[i] = qtrue;
 			continue;
 		}
 
-		p->next = NULL;
-		if (!tail)
-			active = tail = p;
-		else
-		{
-			tail->next = p;
-			tail = p;
-		}
-
+		alpha = pa.fade[i];
 		if (alpha > 1.0)
 			alpha = 1;
 
-		//color = p->color;
-
-		time2 = time*time;
+		org[0] = pa.pos[0][i];
+		org[1] = pa.pos[1][i];
+		org[2] = pa.pos[2][i];
 
-		org[0] = p->org[0] + p->vel[0]*time + p->accel[0]*time2;
-		org[1] = p->org[1] + p->vel[1]*time + p->accel[1]*time2;
-		org[2] = p->org[2] + p->vel[2]*time + p->accel[2]*time2;
+		CG_AddParticleToScene (p, org, alpha);
 
-		//type = p->type;
+		// weather and bubbles wrap around by moving their base
+		if (p->type == P_WEATHER || p->type == P_WEATHER_TURBULENT
+			|| p->type == P_BUBBLE || p->type == P_BUBBLE_TURBULENT)
+			CG_SyncParticle (i);
+	}
 
-		CG_AddParticleToScene (p, org, alpha);
+	// compact in place, keeping the spawn order
+	for (i = 0, n = 0 ; i < numParticles ; i++)
+	{
+		if (pa.dead[i])
+		{
+			freeParticles[numFreeParticles++] = pa.slot[i];
+			continue;
+		}
+		if (n != i)
+			CG_MoveParticle (n, i);
+		n++;
 	}
 
-	active_particles = active;
+	numParticles = n;
+	numSyncedParticles = n;
 }
 
 /*
@@ -1204,12 +1528,9 @@ void CG_ParticleSnowFlurry (qhandle_t pshader, centity_t *cent)
 	if (!pshader)
 		CG_Printf ("CG_ParticleSnowFlurry pshader == ZERO!\n");
 
-	if (!free_particles)
+	if (!numFreeParticles)
 		return;
-	p = free_particles;
-	free_particles = p->next;
-	p->next = active_particles;
-	active_particles = p;
+	p = CG_AllocParticle ();
 	p->time = cg.time;
 	p->color = 0;
 	p->alpha = 0.90f;
@@ -1271,12 +1592,9 @@ void CG_ParticleSnow (qhandle_t pshader, vec3_t origin, vec3_t origin2, int turb
 	if (!pshader)
 		CG_Printf ("CG_ParticleSnow pshader == ZERO!\n");
 
-	if (!free_particles)
+	if (!numFreeParticles)
 		return;
-	p = free_particles;
-	free_particles = p->next;
-	p->next = active_particles;
-	active_particles = p;
+	p = CG_AllocParticle ();
 	p->time = cg.time;
 	p->color = 0;
 	p->alpha = 0.40f;
@@ -1329,12 +1647,9 @@ void CG_ParticleBubble (qhandle_t pshader, vec3_t origin, vec3_t origin2, int tu
 	if (!pshader)
 		CG_Printf ("CG_ParticleSnow pshader == ZERO!\n");
 
-	if (!free_particles)
+	if (!numFreeParticles)
 		return;
-	p = free_particles;
-	free_particles = p->next;
-	p->next = active_particles;
-	active_particles = p;
+	p = CG_AllocParticle ();
 	p->time = cg.time;
 	p->color = 0;
 	p->alpha = 0.40f;
@@ -1392,12 +1707,9 @@ void CG_ParticleSmoke (qhandle_t pshader, centity_t *cent)
 	if (!pshader)
 		CG_Printf ("CG_ParticleSmoke == ZERO!\n");
 
-	if (!free_particles)
+	if (!numFreeParticles)
 		return;
-	p = free_particles;
-	free_particles = p->next;
-	p->next = active_particles;
-	active_particles = p;
+	p = CG_AllocParticle ();
 	p->time = cg.time;
 	
 	p->endtime = cg.time + cent->currentState.time;
@@ -1435,12 +1747,9 @@ void CG_ParticleBulletDebris (vec3_t org, vec3_t vel, int duration)
 
 	cparticle_t	*p;
 
-	if (!free_particles)
+	if (!numFreeParticles)
 		return;
-	p = free_particles;
-	free_particles = p->next;
-	p->next = active_particles;
-	active_particles = p;
+	p = CG_AllocParticle ();
 	p->time = cg.time;
 	
 	p->endtime = cg.time + duration;
@@ -1495,12 +1804,9 @@ void CG_ParticleExplosion( const char *animStr, const vec3_t origin, const vec3_
 		return;
 	}
 
-	if (!free_particles)
+	if (!numFreeParticles)
 		return;
-	p = free_particles;
-	free_particles = p->next;
-	p->next = active_particles;
-	active_particles = p;
+	p = CG_AllocParticle ();
 	p->time = cg.time;
 	p->alpha = 0.5;
 	p->alphavel = 0;
@@ -1610,14 +1916,15 @@ int CG_NewParticleArea (int num)
 
 void	CG_SnowLink (centity_t *cent, qboolean particleOn)
 {
-	cparticle_t		*p, *next;
+	cparticle_t		*p;
 	int id;
+	int i;
 
 	id = cent->currentState.frame;
 
-	for (p=active_particles ; p ; p=next)
+	for (i=0 ; i<numParticles ; i++)
 	{
-		next = p->next;
+		p = &particles[ pa.slot[i] ];
 		
 		if (p->type == P_WEATHER || p->type == P_WEATHER_TURBULENT)
 		{
@@ -1640,12 +1947,9 @@ void CG_ParticleImpactSmokePuff (qhandle_t pshader, vec3_t origin)
 	if (!pshader)
 		CG_Printf ("CG_ParticleImpactSmokePuff pshader == ZERO!\n");
 
-	if (!free_particles)
+	if (!numFreeParticles)
 		return;
-	p = free_particles;
-	free_particles = p->next;
-	p->next = active_particles;
-	active_particles = p;
+	p = CG_AllocParticle ();
 	p->time = cg.time;
 	p->alpha = 0.25;
 	p->alphavel = 0;
@@ -1680,12 +1984,9 @@ void CG_Particle_Bleed (qhandle_t pshader, vec3_t start, vec3_t dir, int fleshEn
 	if (!pshader)
 		CG_Printf ("CG_Particle_Bleed pshader == ZERO!\n");
 
-	if (!free_particles)
+	if (!numFreeParticles)
 		return;
-	p = free_particles;
-	free_particles = p->next;
-	p->next = active_particles;
-	active_particles = p;
+	p = CG_AllocParticle ();
 	p->time = cg.time;
 	p->alpha = 1.0;
 	p->alphavel = 0;
@@ -1741,12 +2042,9 @@ void CG_Particle_OilParticle (qhandle_t pshader, centity_t *cent)
 	if (!pshader)
 		CG_Printf ("CG_Particle_OilParticle == ZERO!\n");
 
-	if (!free_particles)
+	if (!numFreeParticles)
 		return;
-	p = free_particles;
-	free_particles = p->next;
-	p->next = active_particles;
-	active_particles = p;
+	p = CG_AllocParticle ();
 	p->time = cg.time;
 	p->alpha = 1.0;
 	p->alphavel = 0;
@@ -1794,12 +2092,9 @@ void CG_Particle_OilSlick (qhandle_t pshader, centity_t *cent)
   	if (!pshader)
 		CG_Printf ("CG_Particle_OilSlick == ZERO!\n");
 
-	if (!free_particles)
+	if (!numFreeParticles)
 		return;
-	p = free_particles;
-	free_particles = p->next;
-	p->next = active_particles;
-	active_particles = p;
+	p = CG_AllocParticle ();
 	p->time = cg.time;
 	
 	if (cent->currentState.angles2[2])
@@ -1855,17 +2150,18 @@ void CG_Particle_OilSlick (qhandle_t pshader, centity_t *cent)
 
 void CG_OilSlickRemove (centity_t *cent)
 {
-	cparticle_t		*p, *next;
+	cparticle_t		*p;
 	int				id;
+	int				i;
 
 	id = 1.0f;
 
 	if (!id)
 		CG_Printf ("CG_OilSlickRevove NULL id\n");
 
-	for (p=active_particles ; p ; p=next)
+	for (i=0 ; i<numParticles ; i++)
 	{
-		next = p->next;
+		p = &particles[ pa.slot[i] ];
 		
 		if (p->type == P_FLAT_SCALEUP)
 		{
@@ -1874,7 +2170,7 @@ void CG_OilSlickRemove (centity_t *cent)
 				p->endtime = cg.time + 100;
 				p->startfade = p->endtime;
 				p->type = P_FLAT_SCALEUP_FADE;
-
+				CG_SyncParticle (i);
 			}
 		}
 
@@ -1937,7 +2233,7 @@ void CG_BloodPool (localEntity_t *le, qhandle_t pshader, trace_t *tr)
 	if (!pshader)
 		CG_Printf ("CG_BloodPool pshader == ZERO!\n");
 
-	if (!free_particles)
+	if (!numFreeParticles)
 		return;
 	
 	VectorCopy (tr->endpos, start);
@@ -1946,10 +2242,7 @@ void CG_BloodPool (localEntity_t *le, qhandle_t pshader, trace_t *tr)
 	if (!legit) 
 		return;
 
-	p = free_particles;
-	free_particles = p->next;
-	p->next = active_particles;
-	active_particles = p;
+	p = CG_AllocParticle ();
 	p->time = cg.time;
 	
 	p->endtime = cg.time + 3000;
@@ -2020,13 +2313,10 @@ void CG_ParticleBloodCloud (centity_t *cent, vec3_t origin, vec3_t dir)
 	{
 		VectorMA (point, crittersize, forward, point);	
 		
-		if (!free_particles)
+		if (!numFreeParticles)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
+		p = CG_AllocParticle ();
 
 		p->time = cg.time;
 		p->alpha = 1.0;
@@ -2069,12 +2359,9 @@ void CG_ParticleSparks (vec3_t org, vec3_t vel, int duration, float x, float y,
 {
 	cparticle_t	*p;
 
-	if (!free_particles)
+	if (!numFreeParticles)
 		return;
-	p = free_particles;
-	free_particles = p->next;
-	p->next = active_particles;
-	active_particles = p;
+	p = CG_AllocParticle ();
 	p->time = cg.time;
 	
 	p->endtime = cg.time + duration;
@@ -2144,13 +2431,10 @@ void CG_ParticleDust (centity_t *cent, vec3_t origin, vec3_t dir)
 	{
 		VectorMA (point, crittersize, forward, point);	
 				
-		if (!free_particles)
+		if (!numFreeParticles)
 			return;
 
-		p = free_particles;
-		free_particles = p->next;
-		p->next = active_particles;
-		active_particles = p;
+		p = CG_AllocParticle ();
 
 		p->time = cg.time;
 		p->alpha = 5.0;
@@ -2216,13 +2500,10 @@ void CG_ParticleMisc (qhandle_t pshader, vec3_t origin, int size, int duration,
 	if (!pshader)
 		CG_Printf ("CG_ParticleImpactSmokePuff pshader == ZERO!\n");
 
-	if (!free_particles)
+	if (!numFreeParticles)
 		return;
 
-	p = free_particles;
-	free_particles = p->next;
-	p->next = active_particles;
-	active_particles = p;
+	p = CG_AllocParticle ();
 	p->time = cg.time;
 	p->alpha = 1.0;
 	p->alphavel = 0;
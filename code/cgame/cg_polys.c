@@ -0,0 +1,132 @@
+//
+// cg_polys.c -- per-frame poly batching
+//
+// Marks, particles and sprite local entities add thousands of small polys
+// a frame. Instead of one trap_R_AddPolyToScene syscall each, polys are
+// collected by shader and vertex count and handed to the renderer with one
+// trap_R_AddPolysToScene per batch when the scene is complete. The
+// renderer sorts polys by shader anyway, so the image is unchanged.
+//
+
+#include "cg_local.h"
+
+#define	MAX_BATCH_VERTS		8192
+#define	MAX_BATCH_POLYS		2048
+#define	MAX_POLY_BATCHES	64
+
+typedef struct {
+	qhandle_t	shader;
+	int			numVerts;		// per poly
+	int			numPolys;
+	int			head, tail;		// poly chain in submission order
+} polyBatch_t;
+
+static polyVert_t	batchVerts[MAX_BATCH_VERTS];
+static int			numBatchVerts;
+
+static int			polyFirstVert[MAX_BATCH_POLYS];
+static int			polyNext[MAX_BATCH_POLYS];
+static int			numBatchPolys;
+
+static polyBatch_t	polyBatches[MAX_POLY_BATCHES];
+static int			numPolyBatches;
+
+static polyVert_t	flushVerts[MAX_BATCH_VERTS];
+
+
+/*
+===============
+CG_ClearPolys
+
+Drops everything collected, called when the scene is cleared
+===============
+*/
+void CG_ClearPolys( void ) {
+	numBatchVerts = 0;
+	numBatchPolys = 0;
+	numPolyBatches = 0;
+}
+
+
+/*
+===============
+CG_FlushPolys
+
+Submits the batches, must be called before the scene is rendered
+===============
+*/
+void CG_FlushPolys( void ) {
+	polyBatch_t	*batch;
+	int			i, p, n;
+
+	for ( i = 0, batch = polyBatches ; i < numPolyBatches ; i++, batch++ ) {
+		if ( batch->numPolys == 1 ) {
+			trap_R_AddPolyToScene( batch->shader, batch->numVerts, batchVerts + polyFirstVert[ batch->head ] );
+			continue;
+		}
+
+		// gather the chain into one contiguous run
+		n = 0;
+		for ( p = batch->head ; p != -1 ; p = polyNext[ p ] ) {
+			memcpy( flushVerts + n, batchVerts + polyFirstVert[ p ], batch->numVerts * sizeof( polyVert_t ) );
+			n += batch->numVerts;
+		}
+		trap_R_AddPolysToScene( batch->shader, batch->numVerts, flushVerts, batch->numPolys );
+	}
+
+	CG_ClearPolys();
+}
+
+
+/*
+===============
+CG_AddPolyToScene
+
+Drop-in replacement for trap_R_AddPolyToScene, with cg_batchPolys 0
+(engines without trap_R_AddPolysToScene) every poly goes straight through
+===============
+*/
+void CG_AddPolyToScene( qhandle_t shader, int numVerts, const polyVert_t *verts ) {
+	polyBatch_t	*batch;
+	int			i, p;
+
+	if ( !cg_batchPolys.integer || numVerts <= 0 || numVerts > MAX_BATCH_VERTS ) {
+		trap_R_AddPolyToScene( shader, numVerts, verts );
+		return;
+	}
+
+	for ( i = 0, batch = polyBatches ; i < numPolyBatches ; i++, batch++ ) {
+		if ( batch->shader == shader && batch->numVerts == numVerts ) {
+			break;
+		}
+	}
+
+	if ( numBatchVerts + numVerts > MAX_BATCH_VERTS || numBatchPolys >= MAX_BATCH_POLYS
+		|| ( i == numPolyBatches && numPolyBatches >= MAX_POLY_BATCHES ) ) {
+		CG_FlushPolys();
+		i = 0;
+		batch = polyBatches;
+	}
+
+	if ( i == numPolyBatches ) {
+		batch->shader = shader;
+		batch->numVerts = numVerts;
+		batch->numPolys = 0;
+		batch->head = -1;
+		numPolyBatches++;
+	}
+
+	p = numBatchPolys++;
+	polyFirstVert[ p ] = numBatchVerts;
+	polyNext[ p ] = -1;
+	memcpy( batchVerts + numBatchVerts, verts, numVerts * sizeof( polyVert_t ) );
+	numBatchVerts += numVerts;
+
+	if ( batch->head == -1 ) {
+		batch->head = p;
+	} else {
+		polyNext[ batch->tail ] = p;
+	}
+	batch->tail = p;
+	batch->numPolys++;
+}
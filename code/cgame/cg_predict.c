@@ -11,9 +11,91 @@ static	pmove_t		cg_pmove;
 
 static	int			cg_numSolidEntities;
 static	centity_t	*cg_solidEntities[MAX_ENTITIES_IN_SNAPSHOT];
+static	vec3_t		cg_solidMins[MAX_ENTITIES_IN_SNAPSHOT];	// relative to the entity origin
+static	vec3_t		cg_solidMaxs[MAX_ENTITIES_IN_SNAPSHOT];
 static	int			cg_numTriggerEntities;
 static	centity_t	*cg_triggerEntities[MAX_ENTITIES_IN_SNAPSHOT];
 
+/*
+====================
+CG_StateBounds
+
+Bounds of one entity state relative to its origin. Brush models
+that may be rotated get a sphere around the origin.
+====================
+*/
+static void CG_StateBounds( const entityState_t *ent, qboolean rotates, vec3_t mins, vec3_t maxs ) {
+	int		x, zd, zu;
+	float	radius;
+
+	if ( ent->solid == SOLID_BMODEL ) {
+		if ( !rotates ) {
+			VectorCopy( cgs.inlineModelMins[ ent->modelindex ], mins );
+			VectorCopy( cgs.inlineModelMaxs[ ent->modelindex ], maxs );
+		} else {
+			radius = cgs.inlineModelRadius[ ent->modelindex ];
+			VectorSet( mins, -radius, -radius, -radius );
+			VectorSet( maxs, radius, radius, radius );
+		}
+	} else {
+		// encoded bbox
+		x = (ent->solid & 255);
+		zd = ((ent->solid>>8) & 255);
+		zu = ((ent->solid>>16) & 255) - 32;
+
+		mins[0] = mins[1] = -x;
+		maxs[0] = maxs[1] = x;
+		mins[2] = -zd;
+		maxs[2] = zu;
+	}
+}
+
+
+/*
+====================
+CG_SolidBounds
+
+Bounds of a solid entity relative to its origin, padded a little
+for the trace epsilons. The list is built when the next snapshot
+arrives, but the clip code uses currentState until the transition
+and nextState after it, so this covers both.
+====================
+*/
+#define	SOLID_BOUNDS_PAD	1
+
+static void CG_SolidBounds( centity_t *cent, vec3_t mins, vec3_t maxs ) {
+	entityState_t	*cur, *next;
+	vec3_t			bmins, bmaxs;
+	qboolean		rotates;
+	int				i;
+
+	cur = &cent->currentState;
+	next = &cent->nextState;
+
+	rotates = cur->apos.trType != TR_STATIONARY || !VectorCompare( cur->apos.trBase, vec3_origin )
+		|| next->apos.trType != TR_STATIONARY || !VectorCompare( next->apos.trBase, vec3_origin );
+
+	CG_StateBounds( next, rotates, mins, maxs );
+
+	if ( cur->solid && cur->number == next->number ) {
+		CG_StateBounds( cur, rotates, bmins, bmaxs );
+		for ( i = 0 ; i < 3 ; i++ ) {
+			if ( bmins[i] < mins[i] ) {
+				mins[i] = bmins[i];
+			}
+			if ( bmaxs[i] > maxs[i] ) {
+				maxs[i] = bmaxs[i];
+			}
+		}
+	}
+
+	for ( i = 0 ; i < 3 ; i++ ) {
+		mins[i] -= SOLID_BOUNDS_PAD;
+		maxs[i] += SOLID_BOUNDS_PAD;
+	}
+}
+
+
 /*
 ====================
 CG_BuildSolidList
@@ -49,6 +131,7 @@ void CG_BuildSolidList( void ) {
 		}
 
 		if ( cent->nextState.solid ) {
+			CG_SolidBounds( cent, cg_solidMins[cg_numSolidEntities], cg_solidMaxs[cg_numSolidEntities] );
 			cg_solidEntities[cg_numSolidEntities] = cent;
 			cg_numSolidEntities++;
 			continue;
@@ -57,6 +140,61 @@ void CG_BuildSolidList( void ) {
 }
 
 
+/*
+====================
+CG_SolidInBox
+
+Broadphase for the clipping functions, origin is where the
+entity is clipped this frame
+====================
+*/
+static qboolean CG_SolidInBox( int num, const vec3_t origin, const vec3_t mins, const vec3_t maxs ) {
+	int		j;
+
+	for ( j = 0 ; j < 3 ; j++ ) {
+		if ( origin[j] + cg_solidMaxs[num][j] < mins[j] || origin[j] + cg_solidMins[num][j] > maxs[j] ) {
+			return qfalse;
+		}
+	}
+
+	return qtrue;
+}
+
+
+/*
+====================
+CG_MoverInBox
+
+Returns qtrue if a moving brush model could reach into the box
+====================
+*/
+qboolean CG_MoverInBox( const vec3_t mins, const vec3_t maxs ) {
+	int			i;
+	centity_t	*cent;
+	entityState_t	*ent;
+	vec3_t		origin;
+
+	for ( i = 0 ; i < cg_numSolidEntities ; i++ ) {
+		cent = cg_solidEntities[ i ];
+		ent = &cent->currentState;
+
+		if ( ent->solid != SOLID_BMODEL ) {
+			continue;
+		}
+		if ( ent->pos.trType == TR_STATIONARY && ent->apos.trType == TR_STATIONARY ) {
+			continue;
+		}
+
+		BG_EvaluateTrajectory( &ent->pos, cg.physicsTime, origin );
+		if ( CG_SolidInBox( i, origin, mins, maxs ) ) {
+			return qtrue;
+		}
+	}
+
+	return qfalse;
+}
+
+
 /*
 ====================
 CG_ClipMoveToEntities
@@ -71,8 +209,24 @@ static void CG_ClipMoveToEntities ( const vec3_t start, const vec3_t mins, const
 	clipHandle_t 	cmodel;
 	vec3_t		bmins, bmaxs;
 	vec3_t		origin, angles;
+	vec3_t		sweepMins, sweepMaxs;
 	centity_t	*cent;
 
+	// box swept by the trace
+	for ( i = 0 ; i < 3 ; i++ ) {
+		if ( start[i] < end[i] ) {
+			sweepMins[i] = start[i];
+			sweepMaxs[i] = end[i];
+		} else {
+			sweepMins[i] = end[i];
+			sweepMaxs[i] = start[i];
+		}
+		if ( mins ) {
+			sweepMins[i] += mins[i];
+			sweepMaxs[i] += maxs[i];
+		}
+	}
+
 	for ( i = 0 ; i < cg_numSolidEntities ; i++ ) {
 		cent = cg_solidEntities[ i ];
 		ent = &cent->currentState;
@@ -83,10 +237,17 @@ static void CG_ClipMoveToEntities ( const vec3_t start, const vec3_t mins, const
 
 		if ( ent->solid == SOLID_BMODEL ) {
 			// special value for bmodel
+			BG_EvaluateTrajectory( &cent->currentState.pos, cg.physicsTime, origin );
+			if ( !CG_SolidInBox( i, origin, sweepMins, sweepMaxs ) ) {
+				continue;
+			}
 			cmodel = trap_CM_InlineModel( ent->modelindex );
 			VectorCopy( cent->lerpAngles, angles );
-			BG_EvaluateTrajectory( &cent->currentState.pos, cg.physicsTime, origin );
 		} else {
+			if ( !CG_SolidInBox( i, cent->lerpOrigin, sweepMins, sweepMaxs ) ) {
+				continue;
+			}
+
 			// encoded bbox
 			x = (ent->solid & 255);
 			zd = ((ent->solid>>8) & 255);
@@ -128,6 +289,8 @@ void	CG_Trace( trace_t *result, const vec3_t start, const vec3_t mins, const vec
 					 int skipNumber, int mask ) {
 	trace_t	t;
 
+	cg_predictFrame.traces++;
+
 	trap_CM_BoxTrace ( &t, start, end, mins, maxs, 0, mask);
 	if ( t.fraction == 1.0 )
 		t.entityNum = ENTITYNUM_NONE;
@@ -168,6 +331,10 @@ int		CG_PointContents( const vec3_t point, int passEntityNum ) {
 			continue;
 		}
 
+		if ( !CG_SolidInBox( i, cent->lerpOrigin, point, point ) ) {
+			continue;
+		}
+
 		cmodel = trap_CM_InlineModel( ent->modelindex );
 		if ( !cmodel ) {
 			continue;
@@ -1003,6 +1170,7 @@ void CG_PredictPlayerState( void ) {
 	if( 1 /* cg_optimizePrediction.integer */ ) {
 		if( cg.nextFrameTeleport || cg.thisFrameTeleport ) {
 			// do a full predict
+			cg_predictFrame.mode = PREDICT_FULL;
 			cg.lastPredictedCommand = 0;
 			cg.stateTail = cg.stateHead;
 			predictCmd = current - CMD_BACKUP + 1;
@@ -1011,6 +1179,7 @@ void CG_PredictPlayerState( void ) {
 		// as the last one
 		else if( cg.physicsTime == cg.lastServerTime ) {
 			// we have no new information, so do an incremental predict
+			cg_predictFrame.mode = PREDICT_INCREMENTAL;
 			predictCmd = cg.lastPredictedCommand + 1;
 		} else {
 			// we have a new snapshot
@@ -1028,6 +1197,7 @@ void CG_PredictPlayerState( void ) {
 				// make sure the state differences are acceptable
 				errorcode = CG_IsUnacceptableError( &cg.predictedPlayerState, &cg.savedPmoveStates[ i ], &moved );
 				if ( errorcode ) {
+					cg_predictFrame.errorCode = errorcode;
 					if( cg_showmiss.integer > 1 )
 						CG_Printf( "errorcode %d at %d\n", errorcode, cg.time );
 					break;
@@ -1042,6 +1212,7 @@ void CG_PredictPlayerState( void ) {
 				predictCmd = cg.lastPredictedCommand + 1;
   
 				// a saved state matched, so flag it
+				cg_predictFrame.mode = PREDICT_MATCHED;
 				error = qfalse;
 				break;
 			}
@@ -1049,6 +1220,7 @@ void CG_PredictPlayerState( void ) {
 			// if no saved states matched
 			if ( error ) {
 				// do a full predict
+				cg_predictFrame.mode = PREDICT_FULL;
 				cg.lastPredictedCommand = 0;
 				cg.stateTail = cg.stateHead;
 				predictCmd = current - CMD_BACKUP + 1;
@@ -1157,6 +1329,7 @@ void CG_PredictPlayerState( void ) {
 		if ( /*cg_optimizePrediction.integer && */ ( cmdNum >= predictCmd || ( stateIndex + 1 ) % NUM_SAVED_STATES == cg.stateHead ) ) {
 
 			Pmove( &cg_pmove );
+			cg_predictFrame.pmoves++;
 
 			// add push trigger movement effects
 			CG_TouchTriggerPrediction();
@@ -1178,6 +1351,7 @@ void CG_PredictPlayerState( void ) {
 		} else {
 			*cg_pmove.ps = cg.savedPmoveStates[ stateIndex ];
 			stateIndex = ( stateIndex + 1 ) % NUM_SAVED_STATES;
+			cg_predictFrame.restored++;
 		}
 
 		moved = qtrue;
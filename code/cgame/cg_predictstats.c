@@ -0,0 +1,220 @@
+//
+// cg_predictstats.c -- opt-in player prediction telemetry
+//
+// With cg_predictStats 1 every frame records how CG_PredictPlayerState got
+// its result (incremental, from a matching saved state or a full replay),
+// how many commands went through Pmove or were restored, the CG_Trace calls
+// of the frame and any CG_IsUnacceptableError code into a ring of recent
+// frames. A graph is drawn left of the lagometer and the "predictstats"
+// command prints min/avg/p99/max.
+//
+
+#include "cg_local.h"
+
+#define PREDICT_FRAMES		512		// must be a power of two
+#define PREDICT_ERRORS		32		// highest CG_IsUnacceptableError code + 1
+
+#define PREDICT_GRAPH_SIZE	48
+#define PREDICT_GRAPH_CMDS	32		// commands for a full height bar
+
+predictFrame_t	cg_predictFrame;
+
+static predictFrame_t	predictRing[PREDICT_FRAMES];
+static int				predictFrames;		// total frames recorded since reset
+
+static const char *predictModeNames[PREDICT_NUM_MODES] = {
+	"skipped",
+	"incremental",
+	"matched",
+	"full"
+};
+
+
+void CG_PredictStatsReset( void ) {
+	memset( &cg_predictFrame, 0, sizeof( cg_predictFrame ) );
+	predictFrames = 0;
+}
+
+
+/*
+================
+CG_PredictStatsEndFrame
+
+Called once per rendered frame, commits what was counted since the
+previous call to the ring.
+================
+*/
+void CG_PredictStatsEndFrame( void ) {
+	if ( cg_predictStats.integer ) {
+		predictRing[ predictFrames & ( PREDICT_FRAMES - 1 ) ] = cg_predictFrame;
+		predictFrames++;
+	}
+
+	memset( &cg_predictFrame, 0, sizeof( cg_predictFrame ) );
+}
+
+
+/*
+================
+CG_DrawPredictStats
+
+One column per frame, newest on the right. The bar height is the number
+of commands run through Pmove, green for incremental frames, yellow when
+a new snapshot matched a saved state and red for full replays. A magenta
+tick on top marks frames where CG_IsUnacceptableError fired.
+================
+*/
+void CG_DrawPredictStats( void ) {
+	const predictFrame_t	*pf;
+	float	ax, ay, aw, ah, v;
+	int		a, count, color;
+
+	if ( !cg_predictStats.integer || !predictFrames ) {
+		return;
+	}
+
+	ax = cgs.screenXmax + 1 - 2 * PREDICT_GRAPH_SIZE;
+#ifdef MISSIONPACK
+	ay = cgs.screenYmax + 1 - 144;
+#else
+	ay = cgs.screenYmax + 1 - PREDICT_GRAPH_SIZE;
+#endif
+	aw = PREDICT_GRAPH_SIZE;
+	ah = PREDICT_GRAPH_SIZE;
+
+	trap_R_SetColor( NULL );
+	CG_DrawPic( ax, ay, aw, ah, cgs.media.lagometerShader );
+	CG_AdjustFrom640( &ax, &ay, &aw, &ah );
+
+	count = predictFrames < PREDICT_FRAMES ? predictFrames : PREDICT_FRAMES;
+	if ( count > aw ) {
+		count = aw;
+	}
+
+	color = -1;
+	for ( a = 0 ; a < count ; a++ ) {
+		pf = &predictRing[ ( predictFrames - 1 - a ) & ( PREDICT_FRAMES - 1 ) ];
+
+		if ( pf->errorCode ) {
+			if ( color != 4 ) {
+				color = 4;
+				trap_R_SetColor( g_color_table[ColorIndex(COLOR_MAGENTA)] );
+			}
+			trap_R_DrawStretchPic( ax + aw - a, ay, 1, 2, 0, 0, 0, 0, cgs.media.whiteShader );
+		}
+
+		if ( pf->mode == PREDICT_SKIPPED || !pf->pmoves ) {
+			continue;
+		}
+		if ( color != pf->mode ) {
+			color = pf->mode;
+			if ( color == PREDICT_INCREMENTAL ) {
+				trap_R_SetColor( g_color_table[ColorIndex(COLOR_GREEN)] );
+			} else if ( color == PREDICT_MATCHED ) {
+				trap_R_SetColor( g_color_table[ColorIndex(COLOR_YELLOW)] );
+			} else {
+				trap_R_SetColor( g_color_table[ColorIndex(COLOR_RED)] );
+			}
+		}
+
+		v = ah * pf->pmoves / PREDICT_GRAPH_CMDS;
+		if ( v > ah ) {
+			v = ah;
+		}
+		trap_R_DrawStretchPic( ax + aw - a, ay + ah - v, 1, v, 0, 0, 0, 0, cgs.media.whiteShader );
+	}
+
+	trap_R_SetColor( NULL );
+}
+
+
+static int QDECL CG_PredictStatsCompare( const void *a, const void *b ) {
+	return *(const int *)a - *(const int *)b;
+}
+
+
+static void CG_PredictStatsPrintRow( const char *name, int *values, int count ) {
+	int	i, total;
+
+	total = 0;
+	for ( i = 0; i < count; i++ ) {
+		total += values[ i ];
+	}
+	qsort( values, count, sizeof( values[0] ), CG_PredictStatsCompare );
+
+	CG_Printf( "%-20s %8i %8.1f %8i %8i\n", name, values[0], (float)total / count,
+		values[ count * 99 / 100 ], values[ count - 1 ] );
+}
+
+
+/*
+================
+CG_PredictStats_f
+
+predictstats [reset]
+================
+*/
+void CG_PredictStats_f( void ) {
+	static int	values[PREDICT_FRAMES];
+	int			modes[PREDICT_NUM_MODES];
+	int			errors[PREDICT_ERRORS];
+	int			count, numErrors, i, j;
+
+	if ( trap_Argc() > 1 ) {
+		if ( !Q_stricmp( CG_Argv( 1 ), "reset" ) ) {
+			CG_PredictStatsReset();
+			CG_Printf( "predictstats: reset\n" );
+			return;
+		}
+		CG_Printf( "usage: predictstats [reset]\n" );
+		return;
+	}
+
+	count = predictFrames < PREDICT_FRAMES ? predictFrames : PREDICT_FRAMES;
+	if ( !count ) {
+		CG_Printf( "predictstats: no frames recorded, set cg_predictStats 1\n" );
+		return;
+	}
+
+	memset( modes, 0, sizeof( modes ) );
+	memset( errors, 0, sizeof( errors ) );
+	numErrors = 0;
+	for ( j = 0; j < count; j++ ) {
+		modes[ predictRing[ j ].mode ]++;
+		if ( predictRing[ j ].errorCode ) {
+			errors[ predictRing[ j ].errorCode & ( PREDICT_ERRORS - 1 ) ]++;
+			numErrors++;
+		}
+	}
+
+	CG_Printf( "predictstats: last %i frames, pmove_fixed %i, pmove_msec %i\n",
+		count, cgs.pmove_fixed, cgs.pmove_msec );
+
+	for ( i = 0; i < PREDICT_NUM_MODES; i++ ) {
+		CG_Printf( "%-20s %8i %7.1f%%\n", predictModeNames[ i ], modes[ i ], modes[ i ] * 100.0f / count );
+	}
+
+	CG_Printf( "%-20s %8i %7.1f%%\n", "unacceptable error", numErrors, numErrors * 100.0f / count );
+	for ( i = 1; i < PREDICT_ERRORS; i++ ) {
+		if ( errors[ i ] ) {
+			CG_Printf( "  code %-13i %8i\n", i, errors[ i ] );
+		}
+	}
+
+	CG_Printf( "%-20s %8s %8s %8s %8s\n", "per frame", "min", "avg", "p99", "max" );
+
+	for ( j = 0; j < count; j++ ) {
+		values[ j ] = predictRing[ j ].pmoves;
+	}
+	CG_PredictStatsPrintRow( "pmove", values, count );
+
+	for ( j = 0; j < count; j++ ) {
+		values[ j ] = predictRing[ j ].restored;
+	}
+	CG_PredictStatsPrintRow( "restored", values, count );
+
+	for ( j = 0; j < count; j++ ) {
+		values[ j ] = predictRing[ j ].traces;
+	}
+	CG_PredictStatsPrintRow( "CG_Trace", values, count );
+}
@@ -39,6 +39,47 @@ static int CG_ValidOrder(const char *p) {
 }
 #endif
 
+// compact scoreboard state, patched by "scd" deltas
+static int	compactValues[MAX_CLIENTS][SCOREBOARD_FIELDS];	// by client number
+static int	compactOrder[MAX_CLIENTS];
+static int	compactNumSorted;
+
+
+/*
+=================
+CG_SetScore
+
+Fills cg.scores[i] from the fields of a "scores" entry
+=================
+*/
+static void CG_SetScore( int i, const int *v ) {
+	score_t	*sc;
+
+	sc = &cg.scores[i];
+	sc->client = v[0];
+	sc->score = v[1];
+	sc->ping = v[2];
+	sc->time = v[3];
+	sc->scoreFlags = v[4];
+	sc->accuracy = v[6];
+	sc->impressiveCount = v[7];
+	sc->excellentCount = v[8];
+	sc->gauntletCount = v[9];
+	sc->defendCount = v[10];
+	sc->assistCount = v[11];
+	sc->perfect = v[12];
+	sc->captures = v[13];
+
+	if ( sc->client < 0 || sc->client >= MAX_CLIENTS ) {
+		sc->client = 0;
+	}
+	cgs.clientinfo[ sc->client ].score = sc->score;
+	cgs.clientinfo[ sc->client ].powerups = v[5];
+
+	sc->team = cgs.clientinfo[sc->client].team;
+}
+
+
 /*
 =================
 CG_ParseScores
@@ -46,7 +87,8 @@ CG_ParseScores
 =================
 */
 static void CG_ParseScores( void ) {
-	int		i, powerups;
+	int		i, j;
+	int		v[SCOREBOARD_FIELDS];
 
 	cg.numScores = atoi( CG_Argv( 1 ) );
 	if ( cg.numScores > MAX_CLIENTS ) {
@@ -58,29 +100,141 @@ static void CG_ParseScores( void ) {
 
 	memset( cg.scores, 0, sizeof( cg.scores ) );
 	for ( i = 0 ; i < cg.numScores ; i++ ) {
-		//
-		cg.scores[i].client = atoi( CG_Argv( i * 14 + 4 ) );
-		cg.scores[i].score = atoi( CG_Argv( i * 14 + 5 ) );
-		cg.scores[i].ping = atoi( CG_Argv( i * 14 + 6 ) );
-		cg.scores[i].time = atoi( CG_Argv( i * 14 + 7 ) );
-		cg.scores[i].scoreFlags = atoi( CG_Argv( i * 14 + 8 ) );
-		powerups = atoi( CG_Argv( i * 14 + 9 ) );
-		cg.scores[i].accuracy = atoi(CG_Argv(i * 14 + 10));
-		cg.scores[i].impressiveCount = atoi(CG_Argv(i * 14 + 11));
-		cg.scores[i].excellentCount = atoi(CG_Argv(i * 14 + 12));
-		cg.scores[i].gauntletCount = atoi(CG_Argv(i * 14 + 13));
-		cg.scores[i].defendCount = atoi(CG_Argv(i * 14 + 14));
-		cg.scores[i].assistCount = atoi(CG_Argv(i * 14 + 15));
-		cg.scores[i].perfect = atoi(CG_Argv(i * 14 + 16));
-		cg.scores[i].captures = atoi(CG_Argv(i * 14 + 17));
-
-		if ( cg.scores[i].client < 0 || cg.scores[i].client >= MAX_CLIENTS ) {
-			cg.scores[i].client = 0;
+		for ( j = 0 ; j < SCOREBOARD_FIELDS ; j++ ) {
+			v[j] = atoi( CG_Argv( i * SCOREBOARD_FIELDS + 4 + j ) );
+		}
+		CG_SetScore( i, v );
+	}
+#ifdef MISSIONPACK
+	CG_SetScoreSelection(NULL);
+#endif
+}
+
+
+/*
+=================
+CG_RequestScores
+
+Compact scoreboard clients tell the server which board they have
+=================
+*/
+void CG_RequestScores( void ) {
+	if ( cg_compactScores.integer && cgs.compactScores ) {
+		trap_SendClientCommand( va( "score %i", cg.scoreSeq ) );
+	} else {
+		trap_SendClientCommand( "score" );
+	}
+}
+
+
+/*
+=================
+CG_HexDigit / CG_ParseHex
+=================
+*/
+static int CG_HexDigit( char c ) {
+	if ( c >= '0' && c <= '9' ) {
+		return c - '0';
+	}
+	if ( c >= 'a' && c <= 'f' ) {
+		return c - 'a' + 10;
+	}
+	return -1;
+}
+
+
+static const char *CG_ParseHex( const char *s, int *value ) {
+	unsigned	u;
+	qboolean	negative;
+	int			d;
+
+	negative = ( *s == '-' );
+	if ( negative ) {
+		s++;
+	}
+
+	u = 0;
+	for ( ; ( d = CG_HexDigit( *s ) ) >= 0 ; s++ ) {
+		u = u * 16 + d;
+	}
+
+	*value = negative ? -(int)u : (int)u;
+	return s;
+}
+
+
+/*
+=================
+CG_ParseCompactScores
+
+scd <base> <seq> <more> <red> <blue> [o<order>] [<client>.<mask>[.<value>]...]...
+
+Patches the fields that changed since board <base> (0 for an empty one)
+and rebuilds cg.scores once the last part of board <seq> arrived
+=================
+*/
+static void CG_ParseCompactScores( void ) {
+	const char	*s;
+	int			base, seq, more;
+	int			i, j, n, client, mask;
+
+	base = atoi( CG_Argv( 1 ) );
+	seq = atoi( CG_Argv( 2 ) );
+	more = atoi( CG_Argv( 3 ) );
+
+	if ( base ) {
+		if ( base != cg.scoreSeq ) {
+			// missed the baseline, ask for a delta against what we have
+			if ( !cg.demoPlayback && cg.scoresRequestTime + 1000 < cg.time ) {
+				cg.scoresRequestTime = cg.time;
+				CG_RequestScores();
+			}
+			return;
+		}
+	} else if ( seq != cg.scorePendingSeq ) {
+		// first part of a complete board
+		memset( compactValues, 0, sizeof( compactValues ) );
+		compactNumSorted = 0;
+	}
+
+	cg.teamScores[0] = atoi( CG_Argv( 4 ) );
+	cg.teamScores[1] = atoi( CG_Argv( 5 ) );
+
+	n = trap_Argc();
+	for ( i = 6 ; i < n ; i++ ) {
+		s = CG_Argv( i );
+
+		if ( *s == 'o' ) {
+			for ( s++, compactNumSorted = 0 ; s[0] && s[1] && compactNumSorted < MAX_CLIENTS ; s += 2 ) {
+				client = CG_HexDigit( s[0] ) * 16 + CG_HexDigit( s[1] );
+				compactOrder[ compactNumSorted++ ] = client & ( MAX_CLIENTS - 1 );
+			}
+			continue;
 		}
-		cgs.clientinfo[ cg.scores[i].client ].score = cg.scores[i].score;
-		cgs.clientinfo[ cg.scores[i].client ].powerups = powerups;
 
-		cg.scores[i].team = cgs.clientinfo[cg.scores[i].client].team;
+		s = CG_ParseHex( s, &client );
+		if ( (unsigned)client >= MAX_CLIENTS || *s != '.' ) {
+			continue;
+		}
+		s = CG_ParseHex( s + 1, &mask );
+		for ( j = 0 ; j < SCOREBOARD_FIELDS && *s == '.' ; j++ ) {
+			if ( mask & ( 1 << j ) ) {
+				s = CG_ParseHex( s + 1, &compactValues[client][j] );
+			}
+		}
+	}
+
+	if ( more ) {
+		cg.scorePendingSeq = seq;
+		return;
+	}
+	cg.scorePendingSeq = 0;
+	cg.scoreSeq = seq;
+
+	cg.numScores = compactNumSorted;
+	memset( cg.scores, 0, sizeof( cg.scores ) );
+	for ( i = 0 ; i < cg.numScores ; i++ ) {
+		CG_SetScore( i, compactValues[ compactOrder[i] ] );
 	}
 #ifdef MISSIONPACK
 	CG_SetScoreSelection(NULL);
@@ -144,6 +298,7 @@ void CG_ParseServerinfo( void ) {
 	Q_strncpyz( cgs.redTeam, Info_ValueForKey( info, "g_redTeam" ), sizeof(cgs.redTeam) );
 	Q_strncpyz( cgs.blueTeam, Info_ValueForKey( info, "g_blueTeam" ), sizeof(cgs.blueTeam) );
 	cgs.tvPlayback = atoi( Info_ValueForKey( info, "tv" ) ) ? qtrue : qfalse;
+	cgs.compactScores = atoi( Info_ValueForKey( info, "g_compactScores" ) ) ? qtrue : qfalse;
 }
 
 
@@ -1149,6 +1304,11 @@ static void CG_ServerCommand( void ) {
 		return;
 	}
 
+	if ( !strcmp( cmd, "scd" ) ) {
+		CG_ParseCompactScores();
+		return;
+	}
+
 	if ( !strcmp( cmd, "tinfo" ) ) {
 		CG_ParseTeamInfo();
 		return;
@@ -77,9 +77,6 @@ void CG_SetInitialSnapshot( snapshot_t *snap ) {
 
 	BG_PlayerStateToEntityState( &snap->ps, &cg_entities[ snap->ps.clientNum ].currentState, qfalse );
 
-	// sort out solid entities
-	CG_BuildSolidList();
-
 	CG_ExecuteNewServerCommands( snap->serverCommandSequence );
 
 	// set our local weapon selection pointer to
@@ -92,6 +89,8 @@ void CG_SetInitialSnapshot( snapshot_t *snap ) {
 
 		memcpy(&cent->currentState, state, sizeof(entityState_t));
 		//cent->currentState = *state;
+		// there is no next snapshot yet, the solid list is built from nextState
+		cent->nextState = cent->currentState;
 		cent->interpolate = qfalse;
 		cent->currentValid = qtrue;
 
@@ -100,6 +99,9 @@ void CG_SetInitialSnapshot( snapshot_t *snap ) {
 		// check for events
 		CG_CheckEvents( cent );
 	}
+
+	// sort out solid entities
+	CG_BuildSolidList();
 }
 
 
@@ -1461,6 +1461,7 @@ void CG_DrawActiveFrame( int serverTime, stereoFrame_t stereoView, qboolean demo
 
 	// clear all the render lists
 	trap_R_ClearScene();
+	CG_ClearPolys();
 
 	// set up cg.snap and possibly cg.nextSnap
 	CG_ProcessSnapshots();
@@ -1587,6 +1588,12 @@ void CG_DrawActiveFrame( int serverTime, stereoFrame_t stereoView, qboolean demo
 		}
 	}
 
+	// commit the prediction counters of this frame
+	CG_PredictStatsEndFrame();
+
+	// submit the batched marks, particles and sprites
+	CG_FlushPolys();
+
 	// actually issue the rendering calls
 	CG_DrawActive( stereoView );
 
@@ -2828,31 +2828,17 @@ qboolean InFieldOfVision(vec3_t viewangles, float fov, vec3_t angles)
 
 /*
 ==================
-BotEntityVisible
+BotEntityVisibility
 
-returns visibility in the range [0, 1] taking fog and water surfaces into account
+the traces of BotEntityVisible, without the field of vision check
 ==================
 */
-float BotEntityVisible(int viewer, vec3_t eye, vec3_t viewangles, float fov, int ent) {
-	int i, contents_mask, passent, hitent, infog, inwater, otherinfog, pc;
+static float BotEntityVisibility(int viewer, vec3_t eye, int ent, aas_entityinfo_t *entinfo, vec3_t middle, int pc) {
+	int i, contents_mask, passent, hitent, infog, inwater, otherinfog;
 	float squaredfogdist, waterfactor, vis, bestvis;
 	bsp_trace_t trace;
-	aas_entityinfo_t entinfo;
-	vec3_t dir, entangles, start, end, middle;
+	vec3_t dir, start, end;
 
-	//calculate middle of bounding box
-	BotEntityInfo(ent, &entinfo);
-	if (!entinfo.valid)
-		return 0;
-	VectorAdd(entinfo.mins, entinfo.maxs, middle);
-	VectorScale(middle, 0.5, middle);
-	VectorAdd(entinfo.origin, middle, middle);
-	//check if entity is within field of vision
-	VectorSubtract(middle, eye, dir);
-	vectoangles(dir, entangles);
-	if (!InFieldOfVision(viewangles, fov, entangles)) return 0;
-	//
-	pc = trap_AAS_PointContents(eye);
 	infog = (pc & CONTENTS_FOG);
 	inwater = (pc & (CONTENTS_LAVA|CONTENTS_SLIME|CONTENTS_WATER));
 	//
@@ -2928,12 +2914,90 @@ float BotEntityVisible(int viewer, vec3_t eye, vec3_t viewangles, float fov, int
 			if (bestvis >= 0.95) return bestvis;
 		}
 		//check bottom and top of bounding box as well
-		if (i == 0) middle[2] += entinfo.mins[2];
-		else if (i == 1) middle[2] += entinfo.maxs[2] - entinfo.mins[2];
+		if (i == 0) middle[2] += entinfo->mins[2];
+		else if (i == 1) middle[2] += entinfo->maxs[2] - entinfo->mins[2];
 	}
 	return bestvis;
 }
 
+/*
+==================
+BotEntityVisible
+
+returns visibility in the range [0, 1] taking fog and water surfaces into account
+
+The traces are shared by all bots during a server frame, keyed on the cell
+the eye is in, the entity looked at and the contents at the eye that
+decide the trace mask. Only the field of vision is checked per call.
+==================
+*/
+#define BOTVIS_CACHE_SIZE		1024	// must be a power of two
+#define BOTVIS_CACHE_PROBES		4
+#define BOTVIS_CELL_SIZE		8
+#define BOTVIS_CONTENTS			(CONTENTS_FOG|CONTENTS_LAVA|CONTENTS_SLIME|CONTENTS_WATER)
+
+typedef struct {
+	int time;						//level.time the entry was made, 0 for none
+	int cell[3];
+	int ent;
+	int contents;
+	float vis;
+} botvis_t;
+
+static botvis_t botviscache[BOTVIS_CACHE_SIZE];
+
+static void BotClearVisibilityCache(void) {
+	memset(botviscache, 0, sizeof(botviscache));
+}
+
+float BotEntityVisible(int viewer, vec3_t eye, vec3_t viewangles, float fov, int ent) {
+	int i, pc, cell[3];
+	unsigned int hash;
+	aas_entityinfo_t entinfo;
+	vec3_t dir, entangles, middle;
+	botvis_t *bv, *slot;
+
+	//calculate middle of bounding box
+	BotEntityInfo(ent, &entinfo);
+	if (!entinfo.valid)
+		return 0;
+	VectorAdd(entinfo.mins, entinfo.maxs, middle);
+	VectorScale(middle, 0.5, middle);
+	VectorAdd(entinfo.origin, middle, middle);
+	//check if entity is within field of vision
+	VectorSubtract(middle, eye, dir);
+	vectoangles(dir, entangles);
+	if (!InFieldOfVision(viewangles, fov, entangles)) return 0;
+	//
+	pc = trap_AAS_PointContents(eye) & BOTVIS_CONTENTS;
+	for (i = 0; i < 3; i++) {
+		cell[i] = (int)floor(eye[i] / BOTVIS_CELL_SIZE);
+	}
+	hash = (unsigned int)cell[0] * 73856093u ^ (unsigned int)cell[1] * 19349663u
+		^ (unsigned int)cell[2] * 83492791u ^ (unsigned int)ent * 2654435761u;
+	//
+	slot = NULL;
+	for (i = 0; i < BOTVIS_CACHE_PROBES; i++) {
+		bv = &botviscache[(hash + i) & (BOTVIS_CACHE_SIZE - 1)];
+		if (bv->time != level.time) {
+			if (!slot) slot = bv;
+			continue;
+		}
+		if (bv->ent == ent && bv->contents == pc && bv->cell[0] == cell[0]
+				&& bv->cell[1] == cell[1] && bv->cell[2] == cell[2]) {
+			return bv->vis;
+		}
+	}
+	if (!slot) slot = &botviscache[hash & (BOTVIS_CACHE_SIZE - 1)];
+	//
+	slot->time = level.time;
+	VectorCopy(cell, slot->cell);
+	slot->ent = ent;
+	slot->contents = pc;
+	slot->vis = BotEntityVisibility(viewer, eye, ent, &entinfo, middle, pc);
+	return slot->vis;
+}
+
 /*
 ==================
 BotFindEnemy
@@ -5411,6 +5475,9 @@ void BotSetupDeathmatchAI(void) {
 
 	gametype = trap_Cvar_VariableIntegerValue( "g_gametype" );
 
+	BotClearVisibilityCache();
+	BotClearTravelTimeCache();
+
 	trap_Cvar_Register(&bot_rocketjump, "bot_rocketjump", "1", 0);
 	trap_Cvar_Register(&bot_grapple, "bot_grapple", "0", 0);
 	trap_Cvar_Register(&bot_fastchat, "bot_fastchat", "0", 0);
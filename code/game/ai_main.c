@@ -50,6 +50,7 @@ int bot_interbreed;
 int bot_interbreedmatchcount;
 //
 vmCvar_t bot_thinktime;
+vmCvar_t bot_thinkbudget;
 vmCvar_t bot_memorydump;
 vmCvar_t bot_saveroutingcache;
 vmCvar_t bot_pause;
@@ -547,6 +548,27 @@ void BotUpdateInfoConfigStrings(void) {
 	}
 }
 
+/*
+==============
+BotReportThinkCosts
+==============
+*/
+void BotReportThinkCosts(void) {
+	int i;
+	char netname[MAX_NETNAME];
+
+	G_Printf("%-2s %-16s %8s %8s %8s %8s\n", "cl", "name", "thinks", "avg us", "max us", "deferred");
+	for (i = 0; i < level.maxclients; i++) {
+		//
+		if ( !botstates[i] || !botstates[i]->inuse )
+			continue;
+		//
+		ClientName(i, netname, sizeof(netname));
+		G_Printf("%2i %-16s %8i %8i %8i %8i\n", i, netname, botstates[i]->thinks,
+			botstates[i]->thinkcost, botstates[i]->thinkcost_max, botstates[i]->thinkdefers);
+	}
+}
+
 /*
 ==============
 BotInterbreedBots
@@ -1384,6 +1406,169 @@ int BotAILoadMap( int restart ) {
 void ProximityMine_Trigger( gentity_t *trigger, gentity_t *other, trace_t *trace );
 #endif
 
+/*
+==================
+Bot entity sync
+
+Every botlib frame the botlib gets the state of each linked entity, the
+stock botlib unlinks the ones that were not updated so everything is sent
+again. Removals only need to be sent once per slot
+==================
+*/
+typedef struct {
+	int		frames;
+	int		updates;		// states sent
+	int		removes;		// NULL updates
+} botSyncStats_t;
+
+static qboolean			botSyncRemoved[MAX_GENTITIES];	// the botlib was told the entity is gone
+static botSyncStats_t	botSyncStats;
+
+static void BotSyncReset( void ) {
+	memset( botSyncRemoved, 0, sizeof( botSyncRemoved ) );
+	memset( &botSyncStats, 0, sizeof( botSyncStats ) );
+}
+
+static void BotSyncRemove( int entnum ) {
+	if ( botSyncRemoved[entnum] ) {
+		return;
+	}
+	botSyncRemoved[entnum] = qtrue;
+	botSyncStats.removes++;
+	trap_BotLibUpdateEntity( entnum, NULL );
+}
+
+static void BotSyncEntity( int entnum, bot_entitystate_t *state ) {
+	botSyncRemoved[entnum] = qfalse;
+	botSyncStats.updates++;
+	trap_BotLibUpdateEntity( entnum, state );
+}
+
+/*
+==================
+Svcmd_BotEntities_f
+==================
+*/
+void Svcmd_BotEntities_f( void ) {
+	G_Printf( "bot entity sync: %i botlib frames, states sent: %i, removed: %i\n",
+		botSyncStats.frames, botSyncStats.updates, botSyncStats.removes );
+}
+
+/*
+==================
+BotThinkPriority
+
+Bots in combat or close to a human player think first when the
+think budget does not cover everyone
+==================
+*/
+#define BOT_THINK_NEAR_DIST		1500
+
+static int BotThinkPriority(bot_state_t *bs, vec3_t *humans, int numhumans) {
+	vec3_t dir;
+	int i;
+
+	if (bs->enemy >= 0) return 2;
+	for (i = 0; i < numhumans; i++) {
+		VectorSubtract(humans[i], bs->origin, dir);
+		if (VectorLengthSquared(dir) < Square(BOT_THINK_NEAR_DIST)) return 1;
+	}
+	return 0;
+}
+
+/*
+==================
+BotRunThinks
+
+Runs BotAI for the bots whose think time came. With bot_thinkbudget set
+the bots run by priority and the ones whose recent think cost does not
+fit in what is left of the budget wait for the next server frame. The
+first bot always thinks and a bot that is a full think interval late
+can no longer be deferred, so no bot thinks more than bot_thinktime
+late.
+==================
+*/
+static qboolean BotRunThinks(int elapsed_time, int thinktime) {
+	static vec3_t humans[MAX_CLIENTS];
+	int due[MAX_CLIENTS], key[MAX_CLIENTS];
+	int numdue, numhumans, budget, spent, start, cost;
+	int i, j, k, client;
+	bot_state_t *bs;
+	gentity_t *ent;
+
+	budget = bot_thinkbudget.value * 1000;
+
+	numhumans = 0;
+	if (budget > 0) {
+		for (i = 0; i < level.maxclients; i++) {
+			ent = &g_entities[i];
+			if (!ent->inuse || ent->r.svFlags & SVF_BOT) continue;
+			if (ent->client->pers.connected != CON_CONNECTED) continue;
+			VectorCopy(ent->client->ps.origin, humans[numhumans]);
+			numhumans++;
+		}
+	}
+
+	numdue = 0;
+	for( i = 0; i < level.maxclients; i++ ) {
+		bs = botstates[i];
+		if( !bs || !bs->inuse ) {
+			continue;
+		}
+		//
+		bs->botthink_residual += elapsed_time;
+		//
+		if ( bs->botthink_residual < thinktime ) {
+			continue;
+		}
+		if (budget > 0) {
+			// overdue bots first, then by priority, then the longest waiting
+			k = BotThinkPriority(bs, humans, numhumans);
+			if (bs->botthink_residual >= 2 * thinktime) k = 3;
+			for (j = numdue; j > 0; j--) {
+				if (key[j-1] > k) break;
+				if (key[j-1] == k && botstates[due[j-1]]->botthink_residual >= bs->botthink_residual) break;
+				due[j] = due[j-1];
+				key[j] = key[j-1];
+			}
+			due[j] = i;
+			key[j] = k;
+		}
+		else {
+			due[numdue] = i;
+		}
+		numdue++;
+	}
+
+	spent = 0;
+	for (j = 0; j < numdue; j++) {
+		client = due[j];
+		bs = botstates[client];
+		//
+		if (budget > 0 && j > 0 && key[j] < 3 && spent + bs->thinkcost > budget) {
+			// keeps its residual and thinks next frame
+			bs->thinkdefers++;
+			continue;
+		}
+		bs->botthink_residual -= thinktime;
+
+		if (!trap_AAS_Initialized()) return qfalse;
+
+		if (g_entities[client].client->pers.connected == CON_CONNECTED) {
+			start = G_ProfileClock();
+			BotAI(client, (float) thinktime / 1000);
+			cost = G_ProfileClock() - start;
+			spent += cost;
+			//
+			bs->thinks++;
+			if (bs->thinks == 1) bs->thinkcost = cost;
+			else bs->thinkcost = (bs->thinkcost * 7 + cost) / 8;
+			if (cost > bs->thinkcost_max) bs->thinkcost_max = cost;
+		}
+	}
+	return qtrue;
+}
+
 /*
 ==================
 BotAIStartFrame
@@ -1397,7 +1582,6 @@ int BotAIStartFrame(int time) {
 	static int local_time;
 	static int botlib_residual;
 	static int lastbotthink_time;
-	static qboolean skip[MAX_GENTITIES], *s;
 
 	G_CheckBotSpawn();
 
@@ -1407,6 +1591,7 @@ int BotAIStartFrame(int time) {
 	trap_Cvar_Update(&bot_nochat);
 	trap_Cvar_Update(&bot_testrchat);
 	trap_Cvar_Update(&bot_thinktime);
+	trap_Cvar_Update(&bot_thinkbudget);
 	trap_Cvar_Update(&bot_memorydump);
 	trap_Cvar_Update(&bot_saveroutingcache);
 	trap_Cvar_Update(&bot_pause);
@@ -1416,6 +1601,10 @@ int BotAIStartFrame(int time) {
 //		BotTeamplayReport();
 //		trap_Cvar_Set("bot_report", "0");
 		BotUpdateInfoConfigStrings();
+		if (bot_report.integer == 2) {
+			BotReportThinkCosts();
+			trap_Cvar_Set("bot_report", "1");
+		}
 	}
 
 	if (bot_pause.integer) {
@@ -1473,39 +1662,30 @@ int BotAIStartFrame(int time) {
 
 		if (!trap_AAS_Initialized()) return qfalse;
 
+		botSyncStats.frames++;
+
 		//update entities in the botlib
-		s = skip;
-		ent = g_entities;
-		for ( i = 0; i < level.num_entities; i++, s++, ent++ ) {
+		for ( i = 0; i < level.num_entities; i++ ) {
 			ent = &g_entities[i];
 			if ( !ent->inuse || !ent->r.linked || ent->r.svFlags & SVF_NOCLIENT ) {
-				if ( *s == qfalse ) {
-					*s = qtrue;
-					trap_BotLibUpdateEntity( i, NULL );
-				}
+				BotSyncRemove( i );
 				continue;
 			}
 			// do not update missiles
 			if ( ent->s.eType == ET_MISSILE && ent->s.weapon != WP_GRAPPLING_HOOK ) {
-				if ( *s == qfalse ) {
-					*s = qtrue;
-					trap_BotLibUpdateEntity( i, NULL );
-				}
+				BotSyncRemove( i );
 				continue;
 			}
 			// do not update event only entities
 			if ( ent->s.eType > ET_EVENTS ) {
-				if ( *s == qfalse ) {
-					*s = qtrue;
-					trap_BotLibUpdateEntity( i, NULL );
-				}
+				BotSyncRemove( i );
 				continue;
 			}
 #ifdef MISSIONPACK
 			// never link prox mine triggers
 			if (ent->r.contents == CONTENTS_TRIGGER) {
 				if (ent->touch == ProximityMine_Trigger) {
-					trap_BotLibUpdateEntity(i, NULL);
+					BotSyncRemove( i );
 					continue;
 				}
 			}
@@ -1537,8 +1717,7 @@ int BotAIStartFrame(int time) {
 			state.torsoAnim = ent->s.torsoAnim;
 			state.weapon = ent->s.weapon;
 			//
-			*s = qfalse;
-			trap_BotLibUpdateEntity( i, &state );
+			BotSyncEntity( i, &state );
 		}
 
 		BotAIRegularUpdate();
@@ -1547,23 +1726,7 @@ int BotAIStartFrame(int time) {
 	floattime = trap_AAS_Time();
 
 	// execute scheduled bot AI
-	for( i = 0; i < level.maxclients; i++ ) {
-		if( !botstates[i] || !botstates[i]->inuse ) {
-			continue;
-		}
-		//
-		botstates[i]->botthink_residual += elapsed_time;
-		//
-		if ( botstates[i]->botthink_residual >= thinktime ) {
-			botstates[i]->botthink_residual -= thinktime;
-
-			if (!trap_AAS_Initialized()) return qfalse;
-
-			if (g_entities[i].client->pers.connected == CON_CONNECTED) {
-				BotAI(i, (float) thinktime / 1000);
-			}
-		}
-	}
+	if (!BotRunThinks(elapsed_time, thinktime)) return qfalse;
 
 
 	// execute bot user commands every frame
@@ -1692,6 +1855,7 @@ int BotAISetup( int restart ) {
 	int			errnum;
 
 	trap_Cvar_Register(&bot_thinktime, "bot_thinktime", "100", CVAR_CHEAT);
+	trap_Cvar_Register(&bot_thinkbudget, "bot_thinkbudget", "0", 0);
 	trap_Cvar_Register(&bot_memorydump, "bot_memorydump", "0", CVAR_CHEAT);
 	trap_Cvar_Register(&bot_saveroutingcache, "bot_saveroutingcache", "0", CVAR_CHEAT);
 	trap_Cvar_Register(&bot_pause, "bot_pause", "0", CVAR_CHEAT);
@@ -1704,6 +1868,8 @@ int BotAISetup( int restart ) {
 	trap_Cvar_Register(&bot_interbreedcycle, "bot_interbreedcycle", "20", 0);
 	trap_Cvar_Register(&bot_interbreedwrite, "bot_interbreedwrite", "", 0);
 
+	BotSyncReset();
+
 	//if the game is restarted for a tournament
 	if (restart) {
 		return qtrue;
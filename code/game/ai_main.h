@@ -103,6 +103,10 @@ typedef struct bot_state_s
 {
 	int inuse;										//true if this state is used by a bot client
 	int botthink_residual;							//residual for the bot thinks
+	int thinkcost;									//recent think cost in microseconds
+	int thinkcost_max;								//most expensive think
+	int thinks;										//number of thinks
+	int thinkdefers;								//thinks deferred by bot_thinkbudget
 	int client;										//client number of the bot
 	int entitynum;									//entity number of the bot
 	playerState_t cur_ps;							//current player state
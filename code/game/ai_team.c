@@ -84,16 +84,62 @@ int BotNumTeamMates(bot_state_t *bs) {
 /*
 ==================
 BotClientTravelTimeToGoal
+
+Travel times are kept per client and goal area so every bot of a team
+evaluating orders shares them. A client's area is looked up once per
+server frame and the travel times are dropped when the area changes,
+a goal that moved is simply another goal area.
 ==================
 */
+#define MAX_TRAVELTIME_GOALS	4
+
+typedef struct bot_traveltimes_s
+{
+	int time;								//level.time the area was looked up
+	int areanum;							//area the client is in
+	vec3_t origin;							//where the travel times were computed from
+	int numgoals;
+	int goalareas[MAX_TRAVELTIME_GOALS];
+	int traveltimes[MAX_TRAVELTIME_GOALS];
+} bot_traveltimes_t;
+
+static bot_traveltimes_t clienttraveltimes[MAX_CLIENTS];
+
+void BotClearTravelTimeCache(void) {
+	memset(clienttraveltimes, 0, sizeof(clienttraveltimes));
+}
+
 int BotClientTravelTimeToGoal(int client, bot_goal_t *goal) {
 	playerState_t ps;
-	int areanum;
-
-	BotAI_GetClientState(client, &ps);
-	areanum = BotPointAreaNum(ps.origin);
-	if (!areanum) return 1;
-	return trap_AAS_AreaTravelTimeToGoalArea(areanum, ps.origin, goal->areanum, TFL_DEFAULT);
+	bot_traveltimes_t *tt;
+	int i, areanum;
+
+	tt = &clienttraveltimes[client];
+	if (tt->time != level.time) {
+		BotAI_GetClientState(client, &ps);
+		areanum = BotPointAreaNum(ps.origin);
+		if (areanum != tt->areanum || !tt->time) {
+			tt->areanum = areanum;
+			VectorCopy(ps.origin, tt->origin);
+			tt->numgoals = 0;
+		}
+		tt->time = level.time;
+	}
+	if (!tt->areanum) return 1;
+	//
+	for (i = 0; i < tt->numgoals; i++) {
+		if (tt->goalareas[i] == goal->areanum) return tt->traveltimes[i];
+	}
+	if (tt->numgoals >= MAX_TRAVELTIME_GOALS) {
+		for (i = 1; i < MAX_TRAVELTIME_GOALS; i++) {
+			tt->goalareas[i-1] = tt->goalareas[i];
+			tt->traveltimes[i-1] = tt->traveltimes[i];
+		}
+		tt->numgoals--;
+	}
+	tt->goalareas[tt->numgoals] = goal->areanum;
+	tt->traveltimes[tt->numgoals] = trap_AAS_AreaTravelTimeToGoalArea(tt->areanum, tt->origin, goal->areanum, TFL_DEFAULT);
+	return tt->traveltimes[tt->numgoals++];
 }
 
 /*
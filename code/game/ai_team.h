@@ -11,6 +11,7 @@
  *****************************************************************************/
 
 void BotTeamAI(bot_state_t *bs);
+void BotClearTravelTimeCache(void);
 int BotGetTeamMateTaskPreference(bot_state_t *bs, int teammate);
 void BotSetTeamMateTaskPreference(bot_state_t *bs, int teammate, int preference);
 void BotVoiceChat(bot_state_t *bs, int toclient, char *voicechat);
@@ -1258,6 +1258,139 @@ void BG_EvaluateTrajectoryDelta( const trajectory_t *tr, int atTime, vec3_t resu
 }
 
 
+/*
+================
+BG_EvaluateTrajectories
+
+BG_EvaluateTrajectory for count trajectories at the same time, plus
+BG_EvaluateTrajectoryDelta when delta is not NULL. The entries are
+evaluated grouped by trType in tight per-type loops, and TR_SINE
+trajectories sharing a start time and period (mover teams, bobbing
+items) share one sin/cos. Results are bit-identical to the single calls.
+================
+*/
+#define	BATCH_TRAJECTORIES	512
+#define	SINE_CACHE_SIZE		16		// must be a power of two
+
+typedef struct {
+	int		trTime;
+	int		trDuration;		// 0 for an empty slot
+	float	sine;
+	float	cosine;
+} sineCache_t;
+
+void BG_EvaluateTrajectories( const trajectory_t **trs, int count, int atTime, vec3_t *result, vec3_t *delta ) {
+	static int	order[BATCH_TRAJECTORIES];
+	sineCache_t	cache[SINE_CACHE_SIZE], *sc;
+	int			first[TR_GRAVITY + 2];
+	int			i, n, t, k;
+	const trajectory_t	*tr;
+	float		deltaTime;
+	int			stopTime;
+
+	while ( count > BATCH_TRAJECTORIES ) {
+		BG_EvaluateTrajectories( trs, BATCH_TRAJECTORIES, atTime, result, delta );
+		trs += BATCH_TRAJECTORIES;
+		result += BATCH_TRAJECTORIES;
+		if ( delta ) {
+			delta += BATCH_TRAJECTORIES;
+		}
+		count -= BATCH_TRAJECTORIES;
+	}
+
+	// counting sort by type
+	memset( first, 0, sizeof( first ) );
+	for ( i = 0; i < count; i++ ) {
+		t = trs[i]->trType;
+		if ( (unsigned)t > TR_GRAVITY ) {
+			Com_Error( ERR_DROP, "BG_EvaluateTrajectories: unknown trType: %i", t );
+		}
+		first[ t + 1 ]++;
+	}
+	for ( t = 1; t < TR_GRAVITY + 2; t++ ) {
+		first[t] += first[t - 1];
+	}
+	for ( i = 0; i < count; i++ ) {
+		order[ first[ trs[i]->trType ]++ ] = i;
+	}
+	// first[t] is now the end of type t
+	for ( t = TR_GRAVITY + 1; t > 0; t-- ) {
+		first[t] = first[t - 1];
+	}
+	first[0] = 0;
+
+	for ( n = first[TR_STATIONARY]; n < first[TR_LINEAR]; n++ ) {	// and TR_INTERPOLATE
+		i = order[n];
+		VectorCopy( trs[i]->trBase, result[i] );
+		if ( delta ) {
+			VectorClear( delta[i] );
+		}
+	}
+
+	for ( n = first[TR_LINEAR]; n < first[TR_LINEAR_STOP]; n++ ) {
+		i = order[n];
+		tr = trs[i];
+		deltaTime = ( atTime - tr->trTime ) * 0.001;	// milliseconds to seconds
+		VectorMA( tr->trBase, deltaTime, tr->trDelta, result[i] );
+		if ( delta ) {
+			VectorCopy( tr->trDelta, delta[i] );
+		}
+	}
+
+	for ( n = first[TR_LINEAR_STOP]; n < first[TR_SINE]; n++ ) {
+		i = order[n];
+		tr = trs[i];
+		stopTime = tr->trTime + tr->trDuration;
+		deltaTime = ( ( atTime > stopTime ? stopTime : atTime ) - tr->trTime ) * 0.001;
+		if ( deltaTime < 0 ) {
+			deltaTime = 0;
+		}
+		VectorMA( tr->trBase, deltaTime, tr->trDelta, result[i] );
+		if ( delta ) {
+			if ( atTime > stopTime ) {
+				VectorClear( delta[i] );
+			} else {
+				VectorCopy( tr->trDelta, delta[i] );
+			}
+		}
+	}
+
+	if ( first[TR_SINE] < first[TR_GRAVITY] ) {
+		memset( cache, 0, sizeof( cache ) );
+	}
+	for ( n = first[TR_SINE]; n < first[TR_GRAVITY]; n++ ) {
+		i = order[n];
+		tr = trs[i];
+		k = ( (unsigned)tr->trTime * 31u + (unsigned)tr->trDuration ) & ( SINE_CACHE_SIZE - 1 );
+		sc = &cache[k];
+		if ( sc->trDuration != tr->trDuration || sc->trTime != tr->trTime || !sc->trDuration ) {
+			sc->trTime = tr->trTime;
+			sc->trDuration = tr->trDuration;
+			deltaTime = ( ( atTime - tr->trTime ) % tr->trDuration ) / (float) tr->trDuration;
+			sc->sine = sin( deltaTime * M_PI * 2 );
+			deltaTime = ( atTime - tr->trTime ) / (float) tr->trDuration;
+			sc->cosine = cos( deltaTime * M_PI * 2 ) * 0.5;	// derivative of sin = cos
+		}
+		VectorMA( tr->trBase, sc->sine, tr->trDelta, result[i] );
+		if ( delta ) {
+			VectorScale( tr->trDelta, sc->cosine, delta[i] );
+		}
+	}
+
+	for ( n = first[TR_GRAVITY]; n < count; n++ ) {
+		i = order[n];
+		tr = trs[i];
+		deltaTime = ( atTime - tr->trTime ) * 0.001;	// milliseconds to seconds
+		VectorMA( tr->trBase, deltaTime, tr->trDelta, result[i] );
+		result[i][2] -= 0.5 * DEFAULT_GRAVITY * deltaTime * deltaTime;		// FIXME: local gravity...
+		if ( delta ) {
+			VectorCopy( tr->trDelta, delta[i] );
+			delta[i][2] -= DEFAULT_GRAVITY * deltaTime;
+		}
+	}
+}
+
+
 const char *eventnames[EV_MAX] = {
 #define EVENT_STRINGS
 	#include "bg_events.h"
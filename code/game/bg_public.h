@@ -456,9 +456,6 @@ typedef enum {
 	TAG_DONTSPAWN,
 } tag_t;
 
-// Time between location updates
-#define TEAM_LOCATION_UPDATE_TIME		1000
-
 // How many players on the overlay
 #define TEAM_MAXOVERLAY		32
 
@@ -575,8 +572,13 @@ typedef enum {
 #define TMOD_1000 5730265
 #define TMOD_2000 5730265
 
+// integers per player in the "scores" command, also the fields of the
+// compact "scd" scoreboard deltas
+#define	SCOREBOARD_FIELDS	14
+
 void	BG_EvaluateTrajectory( const trajectory_t *tr, int atTime, vec3_t result );
 void	BG_EvaluateTrajectoryDelta( const trajectory_t *tr, int atTime, vec3_t result );
+void	BG_EvaluateTrajectories( const trajectory_t **trs, int count, int atTime, vec3_t *result, vec3_t *delta );
 
 void	BG_AddPredictableEventToPlayerstate( entity_event_t newEvent, int eventParm, playerState_t *ps, int entityNum );
 
@@ -33,7 +33,7 @@ void SP_info_player_deathmatch( gentity_t *ent ) {
 equivelant to info_player_deathmatch
 */
 void SP_info_player_start(gentity_t *ent) {
-	ent->classname = "info_player_deathmatch";
+	G_SetClassname( ent, "info_player_deathmatch" );
 	SP_info_player_deathmatch( ent );
 }
 
@@ -281,7 +281,7 @@ void InitBodyQue (void) {
 	level.bodyQueIndex = 0;
 	for (i=0; i<BODY_QUEUE_SIZE ; i++) {
 		ent = G_Spawn();
-		ent->classname = "bodyque";
+		G_SetClassname( ent, "bodyque" );
 		ent->neverFree = qtrue;
 		level.bodyQue[i] = ent;
 	}
@@ -638,6 +638,16 @@ qboolean ClientUserinfoChanged( int clientNum ) {
 		client->pers.damagePlums = qfalse;
 	}
 
+	// client takes compact scoreboard deltas?
+	if ( atoi( Info_ValueForKey( userinfo, "cg_compactScores" ) ) ) {
+		if ( !client->pers.compactScores ) {
+			client->pers.scoreSeq = 0;
+		}
+		client->pers.compactScores = qtrue;
+	} else {
+		client->pers.compactScores = qfalse;
+	}
+
 	// set name
 	Q_strncpyz( oldname, client->pers.netname, sizeof( oldname ) );
 	s = Info_ValueForKey( userinfo, "name" );
@@ -1095,7 +1105,7 @@ void ClientSpawn(gentity_t *ent) {
 	ent->s.groundEntityNum = ENTITYNUM_NONE;
 	ent->client = &level.clients[index];
 	ent->inuse = qtrue;
-	ent->classname = "player";
+	G_SetClassname( ent, "player" );
 	if ( isSpectator ) {
 		ent->takedamage = qfalse;
 		ent->r.contents = 0;
@@ -1276,7 +1286,7 @@ void ClientDisconnect( int clientNum ) {
 	trap_UnlinkEntity( ent );
 	ent->s.modelindex = 0;
 	ent->inuse = qfalse;
-	ent->classname = "disconnected";
+	G_SetClassname( ent, "disconnected" );
 	ent->client->pers.connected = CON_DISCONNECTED;
 	ent->client->ps.persistant[PERS_TEAM] = TEAM_FREE;
 	ent->client->sess.sessionTeam = TEAM_FREE;
@@ -6,17 +6,93 @@
 #include "../../ui/menudef.h"			// for the voice chats
 #endif
 
+static char scoreboardMessage[MAX_STRING_CHARS];
+
+// the compact "scd" scoreboard sends the fields that changed since the
+// last board a client got, which is kept per client
+#define	SCOREBOARD_PARTS	8
+#define	SCOREBOARD_FULL_TIME	10000	// msec between complete boards, for demos
+
+typedef struct {
+	int		seq;
+	int		teamScores[2];
+	int		numSorted;
+	int		order[MAX_CLIENTS];
+	int		values[MAX_CLIENTS][SCOREBOARD_FIELDS];	// by client number
+} scoreboard_t;
+
+static scoreboard_t	scoreboard;		// newest board
+static scoreboard_t	scoreboardBuild;
+static scoreboard_t	clientScoreboards[MAX_CLIENTS];	// last board sent
+
+// compact message, reused while the board and the base are the same
+static char			compactParts[SCOREBOARD_PARTS][MAX_STRING_CHARS];
+static int			compactNumParts;
+static int			compactBase = -1, compactSeq;
+
+
 /*
 ==================
-DeathmatchScoreboardMessage
+ScoreboardOrderEqual
+==================
+*/
+static qboolean ScoreboardOrderEqual( const scoreboard_t *a, const scoreboard_t *b ) {
+	int		i;
+
+	if ( a->numSorted != b->numSorted ) {
+		return qfalse;
+	}
+	for ( i = 0 ; i < a->numSorted ; i++ ) {
+		if ( a->order[i] != b->order[i] ) {
+			return qfalse;
+		}
+	}
+	return qtrue;
+}
 
+
+/*
+==================
+ScoreboardEqual
+
+Everything but the sequence, rows of clients not on the board are zero
 ==================
 */
-void DeathmatchScoreboardMessage( gentity_t *ent ) {
+static qboolean ScoreboardEqual( const scoreboard_t *a, const scoreboard_t *b ) {
+	int		i, j;
+	const int	*av, *bv;
+
+	if ( a->teamScores[0] != b->teamScores[0] || a->teamScores[1] != b->teamScores[1] ) {
+		return qfalse;
+	}
+	if ( !ScoreboardOrderEqual( a, b ) ) {
+		return qfalse;
+	}
+	for ( i = 0 ; i < a->numSorted ; i++ ) {
+		av = a->values[ a->order[i] ];
+		bv = b->values[ b->order[i] ];
+		for ( j = 0 ; j < SCOREBOARD_FIELDS ; j++ ) {
+			if ( av[j] != bv[j] ) {
+				return qfalse;
+			}
+		}
+	}
+	return qtrue;
+}
+
+
+/*
+==================
+BuildScoreboardMessage
+
+==================
+*/
+static void BuildScoreboardMessage( void ) {
 	char		entry[256]; // enough to hold 14 integers
 	char		string[MAX_STRING_CHARS-1];
 	int			stringlength;
 	int			i, j, ping, prefix;
+	int			*v;
 	gclient_t	*cl;
 	int			numSorted, scoreFlags, accuracy, perfect;
 
@@ -27,6 +103,10 @@ void DeathmatchScoreboardMessage( gentity_t *ent ) {
 
 	numSorted = level.numConnectedClients;
 
+	memset( &scoreboardBuild, 0, sizeof( scoreboardBuild ) );
+	scoreboardBuild.teamScores[0] = level.teamScores[TEAM_RED];
+	scoreboardBuild.teamScores[1] = level.teamScores[TEAM_BLUE];
+
 	// estimate prefix length to avoid oversize of final string
 	prefix = BG_sprintf( entry, "scores %i %i %i", level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE], numSorted );
 	
@@ -48,32 +128,258 @@ void DeathmatchScoreboardMessage( gentity_t *ent ) {
 
 		perfect = ( cl->ps.persistant[PERS_RANK] == 0 && cl->ps.persistant[PERS_KILLED] == 0 ) ? 1 : 0;
 
-		j = BG_sprintf( entry, " %i %i %i %i %i %i %i %i %i %i %i %i %i %i",
-			level.sortedClients[i],
-			cl->ps.persistant[PERS_SCORE],
-			ping,
-			(level.time - cl->pers.enterTime)/60000,
-			scoreFlags,
-			g_entities[level.sortedClients[i]].s.powerups,
-			accuracy, 
-			cl->ps.persistant[PERS_IMPRESSIVE_COUNT],
-			cl->ps.persistant[PERS_EXCELLENT_COUNT],
-			cl->ps.persistant[PERS_GAUNTLET_FRAG_COUNT], 
-			cl->ps.persistant[PERS_DEFEND_COUNT], 
-			cl->ps.persistant[PERS_ASSIST_COUNT], 
-			perfect,
-			cl->ps.persistant[PERS_CAPTURES]);
-
-		if ( stringlength + j + prefix >= sizeof( string ) )
-			break;
+		v = scoreboardBuild.values[ level.sortedClients[i] ];
+		scoreboardBuild.order[ scoreboardBuild.numSorted++ ] = level.sortedClients[i];
+		v[0] = level.sortedClients[i];
+		v[1] = cl->ps.persistant[PERS_SCORE];
+		v[2] = ping;
+		v[3] = (level.time - cl->pers.enterTime)/60000;
+		v[4] = scoreFlags;
+		v[5] = g_entities[level.sortedClients[i]].s.powerups;
+		v[6] = accuracy;
+		v[7] = cl->ps.persistant[PERS_IMPRESSIVE_COUNT];
+		v[8] = cl->ps.persistant[PERS_EXCELLENT_COUNT];
+		v[9] = cl->ps.persistant[PERS_GAUNTLET_FRAG_COUNT];
+		v[10] = cl->ps.persistant[PERS_DEFEND_COUNT];
+		v[11] = cl->ps.persistant[PERS_ASSIST_COUNT];
+		v[12] = perfect;
+		v[13] = cl->ps.persistant[PERS_CAPTURES];
+
+		if ( stringlength >= 0 ) {
+			j = BG_sprintf( entry, " %i %i %i %i %i %i %i %i %i %i %i %i %i %i",
+				v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], v[9], v[10], v[11], v[12], v[13] );
+
+			if ( stringlength + j + prefix >= sizeof( string ) ) {
+				// the text message is full, the compact one gets everybody
+				Com_sprintf( scoreboardMessage, sizeof( scoreboardMessage ), "scores %i %i %i%s", i,
+					level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE],
+					string );
+				stringlength = -1;
+				continue;
+			}
+
+			strcpy( string + stringlength, entry );
+			stringlength += j;
+		}
+	}
+
+	if ( stringlength >= 0 ) {
+		Com_sprintf( scoreboardMessage, sizeof( scoreboardMessage ), "scores %i %i %i%s", i,
+			level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE],
+			string );
+	}
+
+	// only changed boards get a new sequence number
+	if ( scoreboard.seq && ScoreboardEqual( &scoreboardBuild, &scoreboard ) ) {
+		return;
+	}
+	scoreboardBuild.seq = scoreboard.seq + 1;
+	scoreboard = scoreboardBuild;
+}
+
+
+/*
+==================
+G_PutHex
 
-		strcpy( string + stringlength, entry );
-		stringlength += j;
+Lowercase hex with a leading '-' for negative values
+==================
+*/
+static int G_PutHex( char *out, int value ) {
+	char		digits[8];
+	unsigned	u;
+	int			n, len;
+
+	len = 0;
+	if ( value < 0 ) {
+		out[ len++ ] = '-';
+		u = -value;
+	} else {
+		u = value;
+	}
+
+	n = 0;
+	do {
+		digits[ n++ ] = "0123456789abcdef"[ u & 15 ];
+		u >>= 4;
+	} while ( u );
+
+	while ( n ) {
+		out[ len++ ] = digits[ --n ];
 	}
+	out[ len ] = '\0';
 
-	trap_SendServerCommand( ent-g_entities, va( "scores %i %i %i%s", i,
-		level.teamScores[TEAM_RED], level.teamScores[TEAM_BLUE],
-		string ) );
+	return len;
+}
+
+
+/*
+==================
+BuildCompactScoreboard
+
+Splits the difference between two boards into "scd" commands:
+
+scd <base> <seq> <more> <red> <blue> [o<order>] [<client>.<mask>[.<value>]...]...
+
+base 0 is against an empty board. The order token lists the sorted
+client numbers as two hex digits each and is left out when unchanged.
+Each client token has the hex client number, a hex mask of changed
+fields and their values. Clients that were not on the base board get all
+their fields, the cgame may still hold a previous occupant of the slot.
+more is 1 on all but the last command.
+==================
+*/
+static void BuildCompactScoreboard( const scoreboard_t *from, const scoreboard_t *to ) {
+	static const scoreboard_t	empty;
+	static char	rows[MAX_CLIENTS][SCOREBOARD_FIELDS * 10 + 16];
+	static int	rowLen[MAX_CLIENTS];
+	qboolean	onBase[MAX_CLIENTS];
+	char		order[MAX_CLIENTS * 2 + 2];
+	char		*head;
+	int			numRows, i, j, c, mask, len, headLen;
+	const int	*fv, *tv;
+	char		*part;
+
+	if ( !from ) {
+		from = &empty;
+	}
+
+	order[0] = '\0';
+	if ( from == &empty || !ScoreboardOrderEqual( from, to ) ) {
+		order[0] = 'o';
+		for ( i = 0 ; i < to->numSorted ; i++ ) {
+			order[ i * 2 + 1 ] = "0123456789abcdef"[ to->order[i] >> 4 ];
+			order[ i * 2 + 2 ] = "0123456789abcdef"[ to->order[i] & 15 ];
+		}
+		order[ to->numSorted * 2 + 1 ] = '\0';
+	}
+
+	memset( onBase, 0, sizeof( onBase ) );
+	for ( i = 0 ; i < from->numSorted ; i++ ) {
+		onBase[ from->order[i] ] = qtrue;
+	}
+
+	numRows = 0;
+	for ( i = 0 ; i < to->numSorted ; i++ ) {
+		c = to->order[i];
+		fv = from->values[c];
+		tv = to->values[c];
+
+		mask = 0;
+		for ( j = 0 ; j < SCOREBOARD_FIELDS ; j++ ) {
+			if ( fv[j] != tv[j] ) {
+				mask |= 1 << j;
+			}
+		}
+		if ( from != &empty && !onBase[c] ) {
+			mask = ( 1 << SCOREBOARD_FIELDS ) - 1;
+		}
+		if ( !mask ) {
+			continue;
+		}
+
+		len = G_PutHex( rows[numRows], c );
+		rows[numRows][ len++ ] = '.';
+		len += G_PutHex( rows[numRows] + len, mask );
+		for ( j = 0 ; j < SCOREBOARD_FIELDS ; j++ ) {
+			if ( mask & ( 1 << j ) ) {
+				rows[numRows][ len++ ] = '.';
+				len += G_PutHex( rows[numRows] + len, tv[j] );
+			}
+		}
+		rowLen[ numRows++ ] = len;
+	}
+
+	// fill the commands, the header is patched with the "more" flag last
+	compactNumParts = 0;
+	part = NULL;
+	len = headLen = 0;
+	head = NULL;
+	for ( i = -1 ; i < numRows ; i++ ) {
+		if ( i >= 0 ) {
+			j = rowLen[i];
+		} else {
+			j = (int)strlen( order );
+		}
+		if ( !part || len + j + 2 >= MAX_STRING_CHARS ) {
+			if ( compactNumParts == SCOREBOARD_PARTS ) {
+				break;		// can't happen with MAX_CLIENTS rows
+			}
+			part = compactParts[ compactNumParts++ ];
+			len = headLen = BG_sprintf( part, "scd %i %i 1 %i %i", from->seq, to->seq,
+				to->teamScores[0], to->teamScores[1] );
+			head = part;
+		}
+		if ( j ) {
+			part[ len++ ] = ' ';
+			strcpy( part + len, i >= 0 ? rows[i] : order );
+			len += j;
+		}
+	}
+
+	// the last part clears the "more" flag, it's the only single digit
+	// after "scd <base> <seq> "
+	head = strchr( head + 4, ' ' );
+	head = strchr( head + 1, ' ' );
+	head[1] = '0';
+}
+
+
+/*
+==================
+DeathmatchScoreboardMessage
+
+The message doesn't depend on the recipient, so it is built at most once
+per frame (pings, times and powerups) and again only if scores, ranks or
+teams change in between
+
+Clients with cg_compactScores get the "scd" delta against the board they
+have instead, if the server allows g_compactScores. A complete board
+still goes out every SCOREBOARD_FULL_TIME so a demo recorded in the middle
+of a game picks the scoreboard up
+==================
+*/
+void DeathmatchScoreboardMessage( gentity_t *ent ) {
+	const scoreboard_t	*from;
+	gclient_t	*client;
+	int			i, base;
+
+	if ( !level.scoreboardValid || level.scoreboardFrame != level.framenum ) {
+		BuildScoreboardMessage();
+		level.scoreboardValid = qtrue;
+		level.scoreboardFrame = level.framenum;
+	}
+
+	client = ent->client;
+	if ( !g_compactScores.integer || !client->pers.compactScores ) {
+		trap_SendServerCommand( ent-g_entities, scoreboardMessage );
+		return;
+	}
+
+	// delta from the client's board if it still has the one we sent last
+	from = &clientScoreboards[ ent - g_entities ];
+	base = client->pers.scoreSeq;
+	if ( !base || base != from->seq
+		|| level.time - client->pers.scoreFullTime >= SCOREBOARD_FULL_TIME
+		|| level.time < client->pers.scoreFullTime ) {
+		base = 0;
+		from = NULL;
+		client->pers.scoreFullTime = level.time;
+	}
+
+	if ( base != compactBase || scoreboard.seq != compactSeq ) {
+		BuildCompactScoreboard( from, &scoreboard );
+		compactBase = base;
+		compactSeq = scoreboard.seq;
+	}
+
+	for ( i = 0 ; i < compactNumParts ; i++ ) {
+		trap_SendServerCommand( ent-g_entities, compactParts[i] );
+	}
+
+	// reliable commands arrive in order, so this is the client's board now
+	clientScoreboards[ ent - g_entities ] = scoreboard;
+	client->pers.scoreSeq = scoreboard.seq;
 }
 
 
@@ -89,6 +395,25 @@ void Cmd_Score_f( gentity_t *ent ) {
 }
 
 
+/*
+==================
+Cmd_ScoreRequest_f
+
+"score [seq]", compact scoreboard clients tell which board they have
+==================
+*/
+static void Cmd_ScoreRequest_f( gentity_t *ent ) {
+	char	arg[MAX_TOKEN_CHARS];
+
+	if ( trap_Argc() > 1 ) {
+		trap_Argv( 1, arg, sizeof( arg ) );
+		ent->client->pers.scoreSeq = atoi( arg );
+	}
+
+	Cmd_Score_f( ent );
+}
+
+
 /*
 ==================
 CheatsOk
@@ -302,7 +627,7 @@ void Cmd_Give_f( gentity_t *ent )
 
 		it_ent = G_Spawn();
 		VectorCopy( ent->r.currentOrigin, it_ent->s.origin );
-		it_ent->classname = it->classname;
+		G_SetClassname( it_ent, it->classname );
 		G_SpawnItem (it_ent, it);
 		FinishSpawningItem(it_ent );
 		memset( &trace, 0, sizeof( trace ) );
@@ -1884,7 +2209,7 @@ void ClientCommand( int clientNum ) {
 	}
 #endif
 	if (Q_stricmp (cmd, "score") == 0) {
-		Cmd_Score_f (ent);
+		Cmd_ScoreRequest_f (ent);
 		return;
 	}
 
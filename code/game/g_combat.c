@@ -66,7 +66,7 @@ void AddScore( gentity_t *ent, vec3_t origin, int score ) {
 	if ( g_gametype.integer == GT_TEAM ) {
 		AddTeamScore( origin, ent->client->ps.persistant[PERS_TEAM], score );
 	}
-	CalculateRanks();
+	UpdateRanks( ent->client - level.clients );
 }
 
 /*
@@ -316,7 +316,7 @@ void Kamikaze_DeathTimer( gentity_t *self ) {
 	gentity_t *ent;
 
 	ent = G_Spawn();
-	ent->classname = "kamikaze timer";
+	G_SetClassname( ent, "kamikaze timer" );
 	VectorCopy(self->s.pos.trBase, ent->s.pos.trBase);
 	ent->r.svFlags |= SVF_NOCLIENT;
 	ent->think = Kamikaze_DeathActivate;
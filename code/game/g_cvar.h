@@ -45,6 +45,7 @@ G_CVAR( g_logSync, "g_logSync", "0", CVAR_ARCHIVE, 0, qfalse, qfalse )
 G_CVAR( g_password, "g_password", "", CVAR_USERINFO, 0, qfalse, qfalse )
 
 G_CVAR( g_banIPs, "g_banIPs", "", CVAR_ARCHIVE, 0, qfalse, qfalse )
+G_CVAR( g_banIPFile, "g_banIPFile", "bans.txt", CVAR_ARCHIVE, 0, qfalse, qfalse )
 G_CVAR( g_filterBan, "g_filterBan", "1", CVAR_ARCHIVE, 0, qfalse, qfalse )
 
 G_CVAR( g_needpass, "g_needpass", "0", CVAR_SERVERINFO | CVAR_ROM, 0, qfalse, qfalse )
@@ -70,8 +71,12 @@ G_CVAR( g_podiumDrop, "g_podiumDrop", "70", 0, 0, qfalse, qfalse )
 
 G_CVAR( g_allowVote, "g_allowVote", "1", CVAR_ARCHIVE, 0, qfalse, qfalse )
 G_CVAR( g_listEntity, "g_listEntity", "0", 0, 0, qfalse, qfalse )
+G_CVAR( g_profile, "g_profile", "0", 0, 0, qfalse, qfalse )
+G_CVAR( g_teamInfoTime, "g_teamInfoTime", "1000", CVAR_ARCHIVE, 0, qfalse, qfalse )
+G_CVAR( g_compactScores, "g_compactScores", "1", CVAR_SERVERINFO | CVAR_ARCHIVE, 0, qfalse, qfalse )
 
 G_CVAR( g_unlagged, "g_unlagged", "1", CVAR_SERVERINFO | CVAR_ARCHIVE, 0, qfalse, qfalse )
+G_CVAR( g_unlaggedCull, "g_unlaggedCull", "1", 0, 0, qfalse, qfalse )
 G_CVAR( g_predictPVS, "g_predictPVS", "0", CVAR_ARCHIVE, 0, qfalse, qfalse )
 
 #ifdef MISSIONPACK
@@ -251,11 +251,16 @@ typedef struct {
 	int			voteCount;			// to prevent people from constantly calling votes
 	int			teamVoteCount;		// to prevent people from constantly calling votes
 	qboolean	teamInfo;			// send team overlay updates?
+	int			teamInfoSeq;		// overlay the client has, 0 for none
+	int			teamInfoTime;		// level.time it was sent
 	int			voted;
 	int			teamVoted;
 
 	qboolean	inGame;
 	qboolean	damagePlums;		// do we want to display damage numbers?
+	qboolean	compactScores;		// understands "scd" scoreboard deltas
+	int			scoreSeq;			// scoreboard the client has, 0 for none
+	int			scoreFullTime;		// level.time of the last complete scoreboard
 } clientPersistant_t;
 
 // unlagged
@@ -336,6 +341,15 @@ struct gclient_s {
 
 	char		*areabits;
 
+	// Team_GetLocation result for an unchanged position
+	struct {
+		qboolean	valid;
+		vec3_t		origin;
+		int			portals;		// level.areaPortalChanges when cached
+		gentity_t	*head;			// level.locationHead when cached
+		gentity_t	*loc;
+	} location;
+
 	// unlagged
 	clientHistory_t	history[ NUM_CLIENT_HISTORY ];
 	clientHistory_t	saved;
@@ -410,6 +424,10 @@ typedef struct {
 	int			sortedClients[MAX_CLIENTS];		// sorted by score
 	int			follow1, follow2;		// clientNums for auto-follow spectators
 
+	qboolean	scoreboardValid;		// cleared on score, rank and team changes
+	qboolean	scoresChanged;			// CS_SCORES1/2 need to be published
+	int			scoreboardFrame;		// level.framenum the scoreboard was built in
+
 	int			snd_fry;				// sound index for standing in lava
 
 	int			warmupModificationCount;	// for detecting if g_warmup is changed
@@ -454,6 +472,8 @@ typedef struct {
 
 	qboolean	locationLinked;			// target_locations get linked
 	gentity_t	*locationHead;			// head of the location list
+	struct locationGrid_s	*locationGrid;	// built by Team_InitLocations
+	int			areaPortalChanges;		// bumped whenever PVS connectivity changes
 	int			bodyQueIndex;			// dead bodies
 	gentity_t	*bodyQue[BODY_QUEUE_SIZE];
 #ifdef MISSIONPACK
@@ -532,6 +552,10 @@ int		G_ModelIndex( const char *name );
 int		G_SoundIndex( const char *name );
 void	G_TeamCommand( team_t team, const char *cmd );
 void	G_KillBox (gentity_t *ent);
+void	G_InitEntityIndex( void );
+void	G_SetClassname( gentity_t *ent, const char *classname );
+void	G_SetTargetname( gentity_t *ent, const char *targetname );
+void	G_UnindexEntity( gentity_t *ent );
 gentity_t *G_Find (gentity_t *from, int fieldofs, const char *match);
 gentity_t *G_PickTarget (const char *targetname);
 void	G_UseTargets (gentity_t *ent, gentity_t *activator);
@@ -543,6 +567,8 @@ gentity_t *G_TempEntity( vec3_t origin, int event );
 void	G_Sound( gentity_t *ent, int channel, int soundIndex );
 void	G_FreeEntity( gentity_t *e );
 qboolean	G_EntitiesFree( void );
+void	G_InitEntitySlots( void );
+void	Svcmd_EntityStats_f( void );
 
 void	G_TouchTriggers (gentity_t *ent);
 void	G_TouchSolids (gentity_t *ent);
@@ -649,6 +675,7 @@ void ClientSpawn( gentity_t *ent );
 void player_die (gentity_t *self, gentity_t *inflictor, gentity_t *attacker, int damage, int mod);
 void AddScore( gentity_t *ent, vec3_t origin, int score );
 void CalculateRanks( void );
+void UpdateRanks( int clientNum );
 qboolean SpotWouldTelefrag( gentity_t *spot );
 
 //
@@ -656,6 +683,7 @@ qboolean SpotWouldTelefrag( gentity_t *spot );
 //
 qboolean	ConsoleCommand( void );
 void G_ProcessIPBans(void);
+void G_SaveIPBans( void );
 qboolean G_FilterPacket (char *from);
 
 //
@@ -718,6 +746,39 @@ void *G_Alloc( size_t size );
 void G_InitMemory( void );
 void Svcmd_GameMem_f( void );
 
+//
+// g_profile.c
+//
+typedef enum {
+	PROF_BOTAI,
+	PROF_CLIENTTHINK,
+	PROF_RUNFRAME,
+	PROF_ENTITIES,
+	PROF_MISSILES,
+	PROF_CLIENTENDFRAME,
+	PROF_EXITRULES,
+	PROF_TEAMSTATUS,
+	PROF_VOTES,
+	PROF_NUM_PHASES
+} profPhase_t;
+
+typedef enum {
+	PROF_TRACE,
+	PROF_LINKENTITY,
+	PROF_ENTITIESINBOX,
+	PROF_SERVERCOMMAND,
+	PROF_NUM_TRAPS
+} profTrap_t;
+
+extern int profileTraps[PROF_NUM_TRAPS];
+
+void G_ProfileReset( void );
+int G_ProfileClock( void );
+int G_ProfileStart( void );
+void G_ProfileStop( profPhase_t phase, int start );
+void G_ProfileEndFrame( void );
+void Svcmd_Profile_f( void );
+
 //
 // g_session.c
 //
@@ -743,7 +804,7 @@ void G_ResetHistory( gentity_t *ent );
 void G_StoreHistory( gentity_t *ent );
 void G_TimeShiftAllClients( int time, gentity_t *skip );
 void G_UnTimeShiftAllClients( gentity_t *skip );
-void G_DoTimeShiftFor( gentity_t *ent );
+void G_DoTimeShiftFor( gentity_t *ent, const vec3_t start, const vec3_t end, float spread );
 void G_UndoTimeShiftFor( gentity_t *ent );
 void G_UnTimeShiftClient( gentity_t *client );
 void G_PredictPlayerMove( gentity_t *ent, float frametime );
@@ -778,6 +839,7 @@ int BotAILoadMap( int restart );
 qboolean BotAISetupClient(int client, struct bot_settings_s *settings, qboolean restart);
 int BotAIShutdownClient( int client, qboolean restart );
 int BotAIStartFrame( int time );
+void Svcmd_BotEntities_f( void );
 void BotTestAAS(vec3_t origin);
 
 
@@ -1009,11 +1071,27 @@ void	trap_SnapVector( float *v );
 // extension interface
 
 #ifdef Q3_VM
-//
+extern int (*trap_Microseconds)( void );
 #else
 qboolean trap_GetValue( char *value, int valueSize, const char *key );
+int trap_Microseconds( void );
 extern int dll_com_trapGetValue;
+extern int dll_trap_Microseconds;
 #endif
 
+extern	qboolean microsecondClock;
+
+// count the expensive traps for g_profile, g_syscalls.c undefines these
+#define trap_Trace( results, start, mins, maxs, end, passEntityNum, contentmask ) \
+	( profileTraps[PROF_TRACE]++, trap_Trace( results, start, mins, maxs, end, passEntityNum, contentmask ) )
+#define trap_TraceCapsule( results, start, mins, maxs, end, passEntityNum, contentmask ) \
+	( profileTraps[PROF_TRACE]++, trap_TraceCapsule( results, start, mins, maxs, end, passEntityNum, contentmask ) )
+#define trap_LinkEntity( ent ) \
+	( profileTraps[PROF_LINKENTITY]++, trap_LinkEntity( ent ) )
+#define trap_EntitiesInBox( mins, maxs, list, maxcount ) \
+	( profileTraps[PROF_ENTITIESINBOX]++, trap_EntitiesInBox( mins, maxs, list, maxcount ) )
+#define trap_SendServerCommand( clientNum, text ) \
+	( profileTraps[PROF_SERVERCOMMAND]++, trap_SendServerCommand( clientNum, text ) )
+
 extern	int svf_self_portal2;
 
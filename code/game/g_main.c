@@ -44,10 +44,14 @@ static void SendScoreboardMessageToAllClients( void );
 // extension interface
 #ifdef Q3_VM
 qboolean (*trap_GetValue)( char *value, int valueSize, const char *key );
+int (*trap_Microseconds)( void );
 #else
 int dll_com_trapGetValue;
+int dll_trap_Microseconds;
 #endif
 
+qboolean	microsecondClock;
+
 int	svf_self_portal2;
 
 /*
@@ -59,6 +63,8 @@ This must be the very first function compiled into the .q3vm file
 ================
 */
 DLLEXPORT intptr_t vmMain( int command, int arg0, int arg1, int arg2 ) {
+	int start;
+
 	switch ( command ) {
 	case GAME_INIT:
 		G_InitGame( arg0, arg1, arg2 );
@@ -69,7 +75,9 @@ DLLEXPORT intptr_t vmMain( int command, int arg0, int arg1, int arg2 ) {
 	case GAME_CLIENT_CONNECT:
 		return (intptr_t)ClientConnect( arg0, arg1, arg2 );
 	case GAME_CLIENT_THINK:
+		start = G_ProfileStart();
 		ClientThink( arg0 );
+		G_ProfileStop( PROF_CLIENTTHINK, start );
 		return 0;
 	case GAME_CLIENT_USERINFO_CHANGED:
 		ClientUserinfoChanged( arg0 );
@@ -89,7 +97,10 @@ DLLEXPORT intptr_t vmMain( int command, int arg0, int arg1, int arg2 ) {
 	case GAME_CONSOLE_COMMAND:
 		return ConsoleCommand();
 	case BOTAI_START_FRAME:
-		return BotAIStartFrame( arg0 );
+		start = G_ProfileStart();
+		arg0 = BotAIStartFrame( arg0 );
+		G_ProfileStop( PROF_BOTAI, start );
+		return arg0;
 	case GAME_SERVER_STARTED:
 		G_LogPrintf( "ServerStartup:\n" );
 		return 0;
@@ -187,8 +198,8 @@ void G_FindTeams( void ) {
 
 				// make sure that targets only point at the master
 				if ( e2->targetname ) {
-					e->targetname = e2->targetname;
-					e2->targetname = NULL;
+					G_SetTargetname( e, e2->targetname );
+					G_SetTargetname( e2, NULL );
 				}
 			}
 		}
@@ -477,6 +488,7 @@ static void G_InitGame( int levelTime, int randomSeed, int restart ) {
 	G_Printf ("gamedate: %s\n", __DATE__);
 
 	// extension interface
+	microsecondClock = qfalse;
 	trap_Cvar_VariableStringBuffer( "//trap_GetValue", value, sizeof( value ) );
 	if ( value[0] ) {
 #ifdef Q3_VM
@@ -489,6 +501,14 @@ static void G_InitGame( int levelTime, int randomSeed, int restart ) {
 		} else {
 			svf_self_portal2 = 0;
 		}
+		if ( trap_GetValue( value, sizeof( value ), "trap_Microseconds_Trinity" ) ) {
+#ifdef Q3_VM
+			trap_Microseconds = (void*)~atoi( value );
+#else
+			dll_trap_Microseconds = atoi( value );
+#endif
+			microsecondClock = qtrue;
+		}
 	}
 
 	srand( randomSeed );
@@ -542,6 +562,8 @@ static void G_InitGame( int levelTime, int randomSeed, int restart ) {
 	// initialize all entities for this game
 	memset( g_entities, 0, MAX_GENTITIES * sizeof(g_entities[0]) );
 	level.gentities = g_entities;
+	G_InitEntityIndex();
+	G_InitEntitySlots();
 
 	// initialize all clients for this game
 	level.maxclients = g_maxclients.integer;
@@ -559,7 +581,7 @@ static void G_InitGame( int levelTime, int randomSeed, int restart ) {
 	level.num_entities = MAX_CLIENTS;
 
 	for ( i = 0 ; i < MAX_CLIENTS ; i++ ) {
-		g_entities[ i ].classname = "clientslot";
+		G_SetClassname( &g_entities[ i ], "clientslot" );
 	}
 
 	// let the server system know where the entites are
@@ -638,6 +660,8 @@ static void G_ShutdownGame( int restart )
 	// write all the client session data so we can get it back
 	G_WriteSessionData();
 
+	G_SaveIPBans();
+
 	if ( trap_Cvar_VariableIntegerValue( "bot_enable" ) ) {
 		BotAIShutdown( restart );
 	}
@@ -865,6 +889,85 @@ static int QDECL SortRanks( const void *a, const void *b ) {
 }
 
 
+/*
+============
+SetRanks
+
+Sets the rank value for all clients from level.sortedClients, returns
+qfalse if the playing clients turn out not to be in score order
+============
+*/
+static qboolean SetRanks( void ) {
+	int		i;
+	int		rank;
+	int		score;
+	int		newScore;
+	gclient_t	*cl;
+
+	if ( g_gametype.integer >= GT_TEAM ) {
+		// in team games, rank is just the order of the teams, 0=red, 1=blue, 2=tied
+		for ( i = 0;  i < level.numConnectedClients; i++ ) {
+			cl = &level.clients[ level.sortedClients[i] ];
+			if ( level.teamScores[TEAM_RED] == level.teamScores[TEAM_BLUE] ) {
+				cl->ps.persistant[PERS_RANK] = 2;
+			} else if ( level.teamScores[TEAM_RED] > level.teamScores[TEAM_BLUE] ) {
+				cl->ps.persistant[PERS_RANK] = 0;
+			} else {
+				cl->ps.persistant[PERS_RANK] = 1;
+			}
+		}
+	} else {	
+		rank = -1;
+		score = MAX_QINT;
+		for ( i = 0;  i < level.numPlayingClients; i++ ) {
+			cl = &level.clients[ level.sortedClients[i] ];
+			newScore = cl->ps.persistant[PERS_SCORE];
+			if ( newScore > score ) {
+				return qfalse;
+			}
+			if ( i == 0 || newScore != score ) {
+				rank = i;
+				// assume we aren't tied until the next client is checked
+				level.clients[ level.sortedClients[i] ].ps.persistant[PERS_RANK] = rank;
+			} else {
+				// we are tied with the previous client
+				level.clients[ level.sortedClients[i-1] ].ps.persistant[PERS_RANK] = rank | RANK_TIED_FLAG;
+				level.clients[ level.sortedClients[i] ].ps.persistant[PERS_RANK] = rank | RANK_TIED_FLAG;
+			}
+			score = newScore;
+			if ( g_gametype.integer == GT_SINGLE_PLAYER && level.numPlayingClients == 1 ) {
+				level.clients[ level.sortedClients[i] ].ps.persistant[PERS_RANK] = rank | RANK_TIED_FLAG;
+			}
+		}
+	}
+
+	return qtrue;
+}
+
+
+/*
+============
+RanksChanged
+
+Common tail of CalculateRanks and UpdateRanks
+============
+*/
+static void RanksChanged( void ) {
+	level.scoreboardValid = qfalse;
+
+	// configstrings and cvars go out once per frame, see PublishScores
+	level.scoresChanged = qtrue;
+
+	// see if it is time to end the level
+	CheckExitRules();
+
+	// if we are at the intermission, send the new info to everyone
+	if ( level.intermissiontime ) {
+		SendScoreboardMessageToAllClients();
+	}
+}
+
+
 /*
 ============
 CalculateRanks
@@ -876,10 +979,6 @@ and team change.
 */
 void CalculateRanks( void ) {
 	int		i;
-	int		rank;
-	int		score;
-	int		newScore;
-	gclient_t	*cl;
 
 	if ( level.restarted )
 		return;
@@ -925,41 +1024,79 @@ void CalculateRanks( void ) {
 		sizeof(level.sortedClients[0]), SortRanks );
 
 	// set the rank value for all clients that are connected and not spectators
-	if ( g_gametype.integer >= GT_TEAM ) {
-		// in team games, rank is just the order of the teams, 0=red, 1=blue, 2=tied
-		for ( i = 0;  i < level.numConnectedClients; i++ ) {
-			cl = &level.clients[ level.sortedClients[i] ];
-			if ( level.teamScores[TEAM_RED] == level.teamScores[TEAM_BLUE] ) {
-				cl->ps.persistant[PERS_RANK] = 2;
-			} else if ( level.teamScores[TEAM_RED] > level.teamScores[TEAM_BLUE] ) {
-				cl->ps.persistant[PERS_RANK] = 0;
-			} else {
-				cl->ps.persistant[PERS_RANK] = 1;
-			}
-		}
-	} else {	
-		rank = -1;
-		score = MAX_QINT;
-		for ( i = 0;  i < level.numPlayingClients; i++ ) {
-			cl = &level.clients[ level.sortedClients[i] ];
-			newScore = cl->ps.persistant[PERS_SCORE];
-			if ( i == 0 || newScore != score ) {
-				rank = i;
-				// assume we aren't tied until the next client is checked
-				level.clients[ level.sortedClients[i] ].ps.persistant[PERS_RANK] = rank;
-			} else {
-				// we are tied with the previous client
-				level.clients[ level.sortedClients[i-1] ].ps.persistant[PERS_RANK] = rank | RANK_TIED_FLAG;
-				level.clients[ level.sortedClients[i] ].ps.persistant[PERS_RANK] = rank | RANK_TIED_FLAG;
-			}
-			score = newScore;
-			if ( g_gametype.integer == GT_SINGLE_PLAYER && level.numPlayingClients == 1 ) {
-				level.clients[ level.sortedClients[i] ].ps.persistant[PERS_RANK] = rank | RANK_TIED_FLAG;
-			}
+	SetRanks();
+
+	RanksChanged();
+}
+
+
+/*
+============
+UpdateRanks
+
+Cheaper CalculateRanks for when only the score of "clientNum" changed:
+the client is moved to its new place in level.sortedClients instead of
+sorting everyone again. Falls back to CalculateRanks if the order was
+already stale (scores changed elsewhere without a recalculation)
+============
+*/
+void UpdateRanks( int clientNum ) {
+	int		i, n, tmp;
+	int		*sorted;
+
+	if ( level.restarted )
+		return;
+
+	sorted = level.sortedClients;
+	n = level.numConnectedClients;
+
+	for ( i = 0; i < n; i++ ) {
+		if ( sorted[i] == clientNum ) {
+			break;
 		}
 	}
 
-	// set the CS_SCORES1/2 configstrings, which will be visible to everyone
+	if ( i == n ) {
+		CalculateRanks();
+		return;
+	}
+
+	// move up past everyone with a lower score
+	while ( i > 0 && SortRanks( &sorted[i], &sorted[i-1] ) < 0 ) {
+		tmp = sorted[i]; sorted[i] = sorted[i-1]; sorted[i-1] = tmp;
+		i--;
+	}
+
+	// move down past everyone with a higher score
+	while ( i < n - 1 && SortRanks( &sorted[i+1], &sorted[i] ) < 0 ) {
+		tmp = sorted[i]; sorted[i] = sorted[i+1]; sorted[i+1] = tmp;
+		i++;
+	}
+
+	if ( !SetRanks() ) {
+		CalculateRanks();
+		return;
+	}
+
+	RanksChanged();
+}
+
+
+/*
+============
+PublishScores
+
+Sets the CS_SCORES1/2 configstrings, which will be visible to everyone,
+at most once per frame no matter how many times the ranks changed
+============
+*/
+static void PublishScores( void ) {
+	if ( !level.scoresChanged ) {
+		return;
+	}
+
+	level.scoresChanged = qfalse;
+
 	if ( g_gametype.integer >= GT_TEAM ) {
 		trap_SetConfigstring( CS_SCORES1, va("%i", level.teamScores[TEAM_RED] ) );
 		trap_SetConfigstring( CS_SCORES2, va("%i", level.teamScores[TEAM_BLUE] ) );
@@ -977,14 +1114,6 @@ void CalculateRanks( void ) {
 			trap_SetConfigstring( CS_SCORES2, va("%i", level.clients[ level.sortedClients[1] ].ps.persistant[PERS_SCORE] ) );
 		}
 	}
-
-	// see if it is time to end the level
-	CheckExitRules();
-
-	// if we are at the intermission, send the new info to everyone
-	if ( level.intermissiontime ) {
-		SendScoreboardMessageToAllClients();
-	}
 }
 
 
@@ -1673,6 +1802,9 @@ static void G_WarmupEnd( void )
 		trap_SendServerCommand( i, "map_restart" );
 	}
 
+	// scores and awards were reset
+	level.scoreboardValid = qfalse;
+
 	// respawn items, remove projectiles, etc.
 	ent = level.gentities + MAX_CLIENTS;
 	for ( i = MAX_CLIENTS; i < level.num_entities ; i++, ent++ ) {
@@ -2124,12 +2256,15 @@ static void G_RunFrame( int levelTime ) {
 	gclient_t	*client;
 	static	gentity_t *missiles[ MAX_GENTITIES - MAX_CLIENTS ];
 	int		numMissiles;
+	int		frameStart, start;
 	
 	// if we are waiting for the level to restart, do nothing
 	if ( level.restarted ) {
 		return;
 	}
 
+	frameStart = G_ProfileStart();
+
 	level.framenum++;
 	level.previousTime = level.time;
 	level.time = levelTime;
@@ -2148,6 +2283,7 @@ static void G_RunFrame( int levelTime ) {
 	//
 	// go through all allocated objects
 	//
+	start = G_ProfileStart();
 	ent = &g_entities[0];
 	for (i=0 ; i<level.num_entities ; i++, ent++) {
 		if ( !ent->inuse ) {
@@ -2212,8 +2348,10 @@ static void G_RunFrame( int levelTime ) {
 
 		G_RunThink( ent );
 	}
+	G_ProfileStop( PROF_ENTITIES, start );
 
 	if ( numMissiles ) {
+		start = G_ProfileStart();
 		// unlagged
 		G_TimeShiftAllClients( level.previousTime, NULL );
 		// run missiles
@@ -2221,15 +2359,20 @@ static void G_RunFrame( int levelTime ) {
 			G_RunMissile( missiles[ i ] );
 		// unlagged
 		G_UnTimeShiftAllClients( NULL );
+		G_ProfileStop( PROF_MISSILES, start );
 	}
 
 	// perform final fixups on the players
+	start = G_ProfileStart();
 	ent = &g_entities[0];
 	for (i = 0 ; i < level.maxclients ; i++, ent++ ) {
 		if ( ent->inuse ) {
 			ClientEndFrame( ent );
 		}
 	}
+	G_ProfileStop( PROF_CLIENTENDFRAME, start );
+
+	start = G_ProfileStart();
 
 	// see if it is time to do a tournement restart
 	CheckTournament();
@@ -2237,8 +2380,14 @@ static void G_RunFrame( int levelTime ) {
 	// see if it is time to end the level
 	CheckExitRules();
 
+	G_ProfileStop( PROF_EXITRULES, start );
+
 	// update to team status?
+	start = G_ProfileStart();
 	CheckTeamStatus();
+	G_ProfileStop( PROF_TEAMSTATUS, start );
+
+	start = G_ProfileStart();
 
 	// cancel vote if timed out
 	CheckVote();
@@ -2247,9 +2396,16 @@ static void G_RunFrame( int levelTime ) {
 	CheckTeamVote( TEAM_RED );
 	CheckTeamVote( TEAM_BLUE );
 
+	G_ProfileStop( PROF_VOTES, start );
+
+	// send out score changes made during this frame
+	PublishScores();
+
 	// for tracking changes
 	CheckCvars();
 
+	G_SaveIPBans();
+
 	if (g_listEntity.integer) {
 		for (i = 0; i < MAX_GENTITIES; i++) {
 			G_Printf("%4i: %s\n", i, g_entities[i].classname);
@@ -2257,6 +2413,9 @@ static void G_RunFrame( int levelTime ) {
 		trap_Cvar_Set("g_listEntity", "0");
 	}
 
+	G_ProfileStop( PROF_RUNFRAME, frameStart );
+	G_ProfileEndFrame();
+
 	// unlagged
 	level.frameStartTime = trap_Milliseconds();
 }
@@ -349,7 +349,7 @@ void DropPortalDestination( gentity_t *player ) {
 	VectorCopy( player->r.mins, ent->r.mins );
 	VectorCopy( player->r.maxs, ent->r.maxs );
 
-	ent->classname = "hi_portal destination";
+	G_SetClassname( ent, "hi_portal destination" );
 	ent->s.pos.trType = TR_STATIONARY;
 
 	ent->r.contents = CONTENTS_CORPSE;
@@ -442,7 +442,7 @@ void DropPortalSource( gentity_t *player ) {
 	VectorCopy( player->r.mins, ent->r.mins );
 	VectorCopy( player->r.maxs, ent->r.maxs );
 
-	ent->classname = "hi_portal source";
+	G_SetClassname( ent, "hi_portal source" );
 	ent->s.pos.trType = TR_STATIONARY;
 
 	ent->r.contents = CONTENTS_CORPSE | CONTENTS_TRIGGER;
@@ -160,7 +160,7 @@ static void ProximityMine_Activate( gentity_t *ent ) {
 	// build the proximity trigger
 	trigger = G_Spawn ();
 
-	trigger->classname = "proxmine_trigger";
+	G_SetClassname( trigger, "proxmine_trigger" );
 
 	r = ent->splashRadius;
 	VectorSet( trigger->r.mins, -r, -r, -r );
@@ -506,7 +506,7 @@ gentity_t *fire_plasma (gentity_t *self, vec3_t start, vec3_t dir) {
 	VectorNormalize (dir);
 
 	bolt = G_Spawn();
-	bolt->classname = "plasma";
+	G_SetClassname( bolt, "plasma" );
 	bolt->nextthink = level.time + 10000;
 	bolt->think = G_ExplodeMissile;
 	bolt->s.eType = ET_MISSILE;
@@ -553,7 +553,7 @@ gentity_t *fire_grenade (gentity_t *self, vec3_t start, vec3_t dir) {
 	VectorNormalize (dir);
 
 	bolt = G_Spawn();
-	bolt->classname = "grenade";
+	G_SetClassname( bolt, "grenade" );
 	bolt->nextthink = level.time + 2500;
 	bolt->think = G_ExplodeMissile;
 	bolt->s.eType = ET_MISSILE;
@@ -603,7 +603,7 @@ gentity_t *fire_bfg (gentity_t *self, vec3_t start, vec3_t dir) {
 	VectorNormalize (dir);
 
 	bolt = G_Spawn();
-	bolt->classname = "bfg";
+	G_SetClassname( bolt, "bfg" );
 	bolt->nextthink = level.time + 10000;
 	bolt->think = G_ExplodeMissile;
 	bolt->s.eType = ET_MISSILE;
@@ -652,7 +652,7 @@ gentity_t *fire_rocket (gentity_t *self, vec3_t start, vec3_t dir) {
 	VectorNormalize (dir);
 
 	bolt = G_Spawn();
-	bolt->classname = "rocket";
+	G_SetClassname( bolt, "rocket" );
 	bolt->nextthink = level.time + 15000;
 	bolt->think = G_ExplodeMissile;
 	bolt->s.eType = ET_MISSILE;
@@ -701,7 +701,7 @@ gentity_t *fire_grapple (gentity_t *self, vec3_t start, vec3_t dir) {
 	VectorNormalize (dir);
 
 	hook = G_Spawn();
-	hook->classname = "hook";
+	G_SetClassname( hook, "hook" );
 	hook->nextthink = level.time + 10000;
 	hook->think = Weapon_HookFree;
 	hook->s.eType = ET_MISSILE;
@@ -753,7 +753,7 @@ gentity_t *fire_nail( gentity_t *self, vec3_t start, vec3_t forward, vec3_t righ
 	float		r, u, scale;
 
 	bolt = G_Spawn();
-	bolt->classname = "nail";
+	G_SetClassname( bolt, "nail" );
 	bolt->nextthink = level.time + 10000;
 	bolt->think = G_ExplodeMissile;
 	bolt->s.eType = ET_MISSILE;
@@ -800,7 +800,7 @@ gentity_t *fire_prox( gentity_t *self, vec3_t start, vec3_t dir ) {
 	VectorNormalize (dir);
 
 	bolt = G_Spawn();
-	bolt->classname = "prox mine";
+	G_SetClassname( bolt, "prox mine" );
 	bolt->nextthink = level.time + 3000;
 	bolt->think = G_ExplodeMissile;
 	bolt->s.eType = ET_MISSILE;
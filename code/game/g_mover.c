@@ -397,23 +397,42 @@ qboolean G_MoverPush( gentity_t *pusher, vec3_t move, vec3_t amove, gentity_t **
 G_MoverTeam
 =================
 */
+#define	MAX_TEAM_PARTS	64
+
 void G_MoverTeam( gentity_t *ent ) {
 	vec3_t		move, amove;
 	gentity_t	*part, *obstacle;
-	vec3_t		origin, angles;
+	const trajectory_t	*trs[MAX_TEAM_PARTS * 2];
+	vec3_t		positions[MAX_TEAM_PARTS * 2];
+	int			numParts;
 
 	obstacle = NULL;
 
+	// evaluate the whole team at once, the parts of a bobbing or
+	// rotating team share their sin/cos
+	numParts = 0;
+	for ( part = ent ; part && numParts < MAX_TEAM_PARTS ; part = part->teamchain ) {
+		trs[ numParts * 2 + 0 ] = &part->s.pos;
+		trs[ numParts * 2 + 1 ] = &part->s.apos;
+		numParts++;
+	}
+	BG_EvaluateTrajectories( trs, numParts * 2, level.time, positions, NULL );
+
 	// make sure all team slaves can move before commiting
 	// any moves or calling any think functions
 	// if the move is blocked, all moved objects will be backed out
 	pushed_p = pushed;
-	for (part = ent ; part ; part=part->teamchain) {
+	for ( part = ent, numParts = 0 ; part ; part = part->teamchain, numParts++ ) {
 		// get current position
-		BG_EvaluateTrajectory( &part->s.pos, level.time, origin );
-		BG_EvaluateTrajectory( &part->s.apos, level.time, angles );
-		VectorSubtract( origin, part->r.currentOrigin, move );
-		VectorSubtract( angles, part->r.currentAngles, amove );
+		if ( numParts < MAX_TEAM_PARTS ) {
+			VectorSubtract( positions[ numParts * 2 + 0 ], part->r.currentOrigin, move );
+			VectorSubtract( positions[ numParts * 2 + 1 ], part->r.currentAngles, amove );
+		} else {
+			BG_EvaluateTrajectory( &part->s.pos, level.time, move );
+			BG_EvaluateTrajectory( &part->s.apos, level.time, amove );
+			VectorSubtract( move, part->r.currentOrigin, move );
+			VectorSubtract( amove, part->r.currentAngles, amove );
+		}
 		if ( !G_MoverPush( part, move, amove, &obstacle ) ) {
 			break;	// move was blocked
 		}
@@ -597,6 +616,7 @@ void Reached_BinaryMover( gentity_t *ent ) {
 		// close areaportals
 		if ( ent->teammaster == ent || !ent->teammaster ) {
 			trap_AdjustAreaPortalState( ent, qfalse );
+			level.areaPortalChanges++;
 		}
 	} else {
 		G_Error( "Reached_BinaryMover: bad moverState" );
@@ -637,6 +657,7 @@ void Use_BinaryMover( gentity_t *ent, gentity_t *other, gentity_t *activator ) {
 		// open areaportal
 		if ( ent->teammaster == ent || !ent->teammaster ) {
 			trap_AdjustAreaPortalState( ent, qtrue );
+			level.areaPortalChanges++;
 		}
 		return;
 	}
@@ -894,7 +915,7 @@ void Think_SpawnNewDoorTrigger( gentity_t *ent ) {
 
 	// create a trigger with this size
 	other = G_Spawn ();
-	other->classname = "door_trigger";
+	G_SetClassname( other, "door_trigger" );
 	VectorCopy (mins, other->r.mins);
 	VectorCopy (maxs, other->r.maxs);
 	other->parent = ent;
@@ -1063,7 +1084,7 @@ void SpawnPlatTrigger( gentity_t *ent ) {
 	// the middle trigger will be a thin trigger just
 	// above the starting position
 	trigger = G_Spawn();
-	trigger->classname = "plat_trigger";
+	G_SetClassname( trigger, "plat_trigger" );
 	trigger->touch = Touch_PlatCenterTrigger;
 	trigger->r.contents = CONTENTS_TRIGGER;
 	trigger->parent = ent;
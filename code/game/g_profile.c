@@ -0,0 +1,182 @@
+//
+// g_profile.c -- opt-in per-phase server frame profiler
+//
+// With g_profile 1 the time spent in each phase of a server frame and the
+// number of expensive trap calls are recorded into a ring of recent frames.
+// The "profile" server command prints min/avg/p99/max per phase.
+//
+
+#include "g_local.h"
+
+#define PROFILE_FRAMES	512		// must be a power of two
+
+typedef struct {
+	int		phases[PROF_NUM_PHASES];
+	int		traps[PROF_NUM_TRAPS];
+} profileFrame_t;
+
+static const char *profPhaseNames[PROF_NUM_PHASES] = {
+	"botai",
+	"clientthink",
+	"runframe",
+	"  entities",
+	"  missiles",
+	"  endframe",
+	"  exitrules",
+	"  teamstatus",
+	"  votes"
+};
+
+static const char *profTrapNames[PROF_NUM_TRAPS] = {
+	"trap_Trace",
+	"trap_LinkEntity",
+	"trap_EntitiesInBox",
+	"trap_SendServerCommand"
+};
+
+int profileTraps[PROF_NUM_TRAPS];
+
+static profileFrame_t	profileRing[PROFILE_FRAMES];
+static profileFrame_t	profileCurrent;
+static int				profileFrames;		// total frames recorded since reset
+static qboolean			profileActive;		// only changes on frame boundaries
+
+
+void G_ProfileReset( void ) {
+	memset( &profileCurrent, 0, sizeof( profileCurrent ) );
+	memset( profileTraps, 0, sizeof( profileTraps ) );
+	profileFrames = 0;
+}
+
+
+int G_ProfileClock( void ) {
+	// sub-millisecond clock negotiated in G_InitGame
+	if ( microsecondClock ) {
+		return trap_Microseconds();
+	}
+	return trap_Milliseconds() * 1000;
+}
+
+
+/*
+================
+G_ProfileStart / G_ProfileStop
+
+Brackets a phase, times are accumulated into the current frame.
+================
+*/
+int G_ProfileStart( void ) {
+	if ( !profileActive ) {
+		return 0;
+	}
+	return G_ProfileClock();
+}
+
+
+void G_ProfileStop( profPhase_t phase, int start ) {
+	if ( !profileActive ) {
+		return;
+	}
+	profileCurrent.phases[ phase ] += G_ProfileClock() - start;
+}
+
+
+/*
+================
+G_ProfileEndFrame
+
+Called at the end of G_RunFrame, commits everything measured since the
+previous server frame (bot AI and client commands included) to the ring.
+================
+*/
+void G_ProfileEndFrame( void ) {
+	if ( profileActive ) {
+		memcpy( profileCurrent.traps, profileTraps, sizeof( profileTraps ) );
+		profileRing[ profileFrames & ( PROFILE_FRAMES - 1 ) ] = profileCurrent;
+		profileFrames++;
+	}
+
+	memset( &profileCurrent, 0, sizeof( profileCurrent ) );
+	memset( profileTraps, 0, sizeof( profileTraps ) );
+
+	profileActive = g_profile.integer ? qtrue : qfalse;
+}
+
+
+static int QDECL G_ProfileCompare( const void *a, const void *b ) {
+	return *(const int *)a - *(const int *)b;
+}
+
+
+static void G_ProfilePrintRow( const char *name, int *values, int count, qboolean time ) {
+	int	i, total;
+
+	total = 0;
+	for ( i = 0; i < count; i++ ) {
+		total += values[ i ];
+	}
+	qsort( values, count, sizeof( values[0] ), G_ProfileCompare );
+
+	if ( time ) {
+		G_Printf( "%-24s %8.3f %8.3f %8.3f %8.3f\n", name, values[0] * 0.001f, total * 0.001f / count,
+			values[ count * 99 / 100 ] * 0.001f, values[ count - 1 ] * 0.001f );
+	} else {
+		G_Printf( "%-24s %8i %8.1f %8i %8i\n", name, values[0], (float)total / count,
+			values[ count * 99 / 100 ], values[ count - 1 ] );
+	}
+}
+
+
+/*
+================
+Svcmd_Profile_f
+
+profile [reset]
+================
+*/
+void Svcmd_Profile_f( void ) {
+	static int	values[PROFILE_FRAMES];
+	char		arg[MAX_TOKEN_CHARS];
+	int			count, i, j;
+
+	if ( trap_Argc() > 1 ) {
+		trap_Argv( 1, arg, sizeof( arg ) );
+		if ( !Q_stricmp( arg, "reset" ) ) {
+			G_ProfileReset();
+			G_Printf( "profile: reset\n" );
+			return;
+		}
+		G_Printf( "usage: profile [reset]\n" );
+		return;
+	}
+
+	count = profileFrames < PROFILE_FRAMES ? profileFrames : PROFILE_FRAMES;
+	if ( !count ) {
+		G_Printf( "profile: no frames recorded, set g_profile 1\n" );
+		return;
+	}
+
+	G_Printf( "profile: last %i frames, %s clock\n", count, microsecondClock ? "microsecond" : "millisecond" );
+	G_Printf( "%-24s %8s %8s %8s %8s\n", "phase (msec)", "min", "avg", "p99", "max" );
+
+	for ( i = 0; i < PROF_NUM_PHASES; i++ ) {
+		for ( j = 0; j < count; j++ ) {
+			values[ j ] = profileRing[ j ].phases[ i ];
+		}
+		G_ProfilePrintRow( profPhaseNames[ i ], values, count, qtrue );
+	}
+
+	for ( j = 0; j < count; j++ ) {
+		values[ j ] = profileRing[ j ].phases[ PROF_BOTAI ] + profileRing[ j ].phases[ PROF_CLIENTTHINK ]
+			+ profileRing[ j ].phases[ PROF_RUNFRAME ];
+	}
+	G_ProfilePrintRow( "total", values, count, qtrue );
+
+	G_Printf( "%-24s %8s %8s %8s %8s\n", "calls per frame", "min", "avg", "p99", "max" );
+	for ( i = 0; i < PROF_NUM_TRAPS; i++ ) {
+		for ( j = 0; j < count; j++ ) {
+			values[ j ] = profileRing[ j ].traps[ i ];
+		}
+		G_ProfilePrintRow( profTrapNames[ i ], values, count, qfalse );
+	}
+}
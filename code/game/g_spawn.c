@@ -59,6 +59,7 @@ typedef enum {
 	F_FLOAT,
 	F_LSTRING,			// string on disk, pointer in memory, TAG_LEVEL
 	F_GSTRING,			// string on disk, pointer in memory, TAG_GAME
+	F_ISTRING,			// like F_LSTRING, but identical values share one copy
 	F_VECTOR,
 	F_ANGLEHACK,
 	F_ENTITY,			// index on disk, pointer in memory
@@ -76,16 +77,16 @@ typedef struct
 } field_t;
 
 const field_t fields[] = {
-	{"classname", FOFS(classname), F_LSTRING},
+	{"classname", FOFS(classname), F_ISTRING},
 	{"origin", FOFS(s.origin), F_VECTOR},
 	{"model", FOFS(model), F_LSTRING},
 	{"model2", FOFS(model2), F_LSTRING},
 	{"spawnflags", FOFS(spawnflags), F_INT},
 	{"speed", FOFS(speed), F_FLOAT},
-	{"target", FOFS(target), F_LSTRING},
-	{"targetname", FOFS(targetname), F_LSTRING},
+	{"target", FOFS(target), F_ISTRING},
+	{"targetname", FOFS(targetname), F_ISTRING},
 	{"message", FOFS(message), F_LSTRING},
-	{"team", FOFS(team), F_LSTRING},
+	{"team", FOFS(team), F_ISTRING},
 	{"wait", FOFS(wait), F_FLOAT},
 	{"random", FOFS(random), F_FLOAT},
 	{"count", FOFS(count), F_INT},
@@ -249,6 +250,139 @@ spawn_t	spawns[] = {
 	{0, 0}
 };
 
+//
+// classnames and field keys are looked up through hash tables
+// built on the first spawn, chains are walked in table order so
+// items still take precedence over spawn functions of the same name
+//
+#define SPAWN_HASH_SIZE		256		// must be a power of two
+#define FIELD_HASH_SIZE		64
+#define INTERN_HASH_SIZE	4096
+
+typedef struct {
+	const char	*name;
+	gitem_t		*item;
+	spawn_t		*spawn;
+} spawnHash_t;
+
+static spawnHash_t		spawnHash[SPAWN_HASH_SIZE];
+static const field_t	*fieldHash[FIELD_HASH_SIZE];
+static qboolean			spawnHashBuilt;
+
+static char				*internHash[INTERN_HASH_SIZE];
+static int				numInterned;
+
+
+static unsigned G_SpawnHash( const char *name, qboolean caseless ) {
+	unsigned	hash;
+	int			c;
+
+	hash = 5381;
+	while ( ( c = (unsigned char)*name++ ) != '\0' ) {
+		if ( caseless && c >= 'A' && c <= 'Z' ) {
+			c += 'a' - 'A';
+		}
+		hash = hash * 33 + c;
+	}
+
+	return hash;
+}
+
+
+static void G_HashSpawn( const char *name, gitem_t *item, spawn_t *spawn ) {
+	unsigned	h;
+
+	h = G_SpawnHash( name, qfalse );
+	for ( ;; h++ ) {
+		h &= SPAWN_HASH_SIZE - 1;
+		if ( !spawnHash[ h ].name ) {
+			break;
+		}
+		if ( !strcmp( spawnHash[ h ].name, name ) ) {
+			return;		// first entry wins, like the linear search did
+		}
+	}
+
+	spawnHash[ h ].name = name;
+	spawnHash[ h ].item = item;
+	spawnHash[ h ].spawn = spawn;
+}
+
+
+/*
+===============
+G_InitSpawnHash
+
+Builds the classname and field key tables, they only
+depend on static data so this is done once
+===============
+*/
+static void G_InitSpawnHash( void ) {
+	gitem_t			*item;
+	spawn_t			*s;
+	const field_t	*f;
+	unsigned		h;
+
+	if ( spawnHashBuilt ) {
+		return;
+	}
+	spawnHashBuilt = qtrue;
+
+	for ( item = bg_itemlist + 1 ; item->classname ; item++ ) {
+		G_HashSpawn( item->classname, item, NULL );
+	}
+	for ( s = spawns ; s->name ; s++ ) {
+		G_HashSpawn( s->name, NULL, s );
+	}
+
+	for ( f = fields ; f->name ; f++ ) {
+		h = G_SpawnHash( f->name, qtrue );
+		for ( ;; h++ ) {
+			h &= FIELD_HASH_SIZE - 1;
+			if ( !fieldHash[ h ] ) {
+				fieldHash[ h ] = f;
+				break;
+			}
+			if ( !Q_stricmp( fieldHash[ h ]->name, f->name ) ) {
+				break;
+			}
+		}
+	}
+}
+
+
+static const spawnHash_t *G_FindSpawn( const char *classname ) {
+	unsigned	h;
+
+	h = G_SpawnHash( classname, qfalse );
+	for ( ;; h++ ) {
+		h &= SPAWN_HASH_SIZE - 1;
+		if ( !spawnHash[ h ].name ) {
+			return NULL;
+		}
+		if ( !strcmp( spawnHash[ h ].name, classname ) ) {
+			return &spawnHash[ h ];
+		}
+	}
+}
+
+
+static const field_t *G_FindField( const char *key ) {
+	unsigned	h;
+
+	h = G_SpawnHash( key, qtrue );
+	for ( ;; h++ ) {
+		h &= FIELD_HASH_SIZE - 1;
+		if ( !fieldHash[ h ] ) {
+			return NULL;
+		}
+		if ( !Q_stricmp( fieldHash[ h ]->name, key ) ) {
+			return fieldHash[ h ];
+		}
+	}
+}
+
+
 /*
 ===============
 G_CallSpawn
@@ -258,29 +392,25 @@ returning qfalse if not found
 ===============
 */
 qboolean G_CallSpawn( gentity_t *ent ) {
-	spawn_t	*s;
-	gitem_t	*item;
+	const spawnHash_t	*s;
 
 	if ( !ent->classname ) {
 		G_Printf ("G_CallSpawn: NULL classname\n");
 		return qfalse;
 	}
 
-	// check item spawn functions
-	for ( item=bg_itemlist+1 ; item->classname ; item++ ) {
-		if ( !strcmp(item->classname, ent->classname) ) {
-			G_SpawnItem( ent, item );
-			return qtrue;
-		}
-	}
+	G_InitSpawnHash();
 
-	// check normal spawn functions
-	for ( s=spawns ; s->name ; s++ ) {
-		if ( !strcmp(s->name, ent->classname) ) {
+	s = G_FindSpawn( ent->classname );
+	if ( s ) {
+		if ( s->item ) {
+			// check item spawn functions
+			G_SpawnItem( ent, s->item );
+		} else {
 			// found it
-			s->spawn(ent);
-			return qtrue;
+			s->spawn->spawn(ent);
 		}
+		return qtrue;
 	}
 	G_Printf ("%s doesn't have a spawn function\n", ent->classname);
 	return qfalse;
@@ -322,6 +452,43 @@ char *G_NewString( const char *string ) {
 }
 
 
+/*
+=============
+G_InternString
+
+G_NewString for values that are never modified in place, identical
+strings share one copy in the pool. The table is emptied with the
+pool in G_SpawnEntitiesFromString.
+=============
+*/
+static char *G_InternString( const char *string ) {
+	char		*interned;
+	unsigned	h;
+
+	if ( numInterned >= INTERN_HASH_SIZE / 2 || strchr( string, '\\' ) ) {
+		// keep probes short, and leave linefeed translation to G_NewString
+		return G_NewString( string );
+	}
+
+	h = G_SpawnHash( string, qfalse );
+	for ( ;; h++ ) {
+		h &= INTERN_HASH_SIZE - 1;
+		if ( !internHash[ h ] ) {
+			break;
+		}
+		if ( !strcmp( internHash[ h ], string ) ) {
+			return internHash[ h ];
+		}
+	}
+
+	interned = G_NewString( string );
+	internHash[ h ] = interned;
+	numInterned++;
+
+	return interned;
+}
+
+
 
 
 /*
@@ -338,39 +505,41 @@ void G_ParseField( const char *key, const char *value, gentity_t *ent ) {
 	float	v;
 	vec3_t	vec;
 
-	for ( f=fields ; f->name ; f++ ) {
-		if ( !Q_stricmp(f->name, key) ) {
-			// found it
-			b = (byte *)ent;
+	f = G_FindField( key );
+	if ( !f ) {
+		return;
+	}
 
-			switch( f->type ) {
-			case F_LSTRING:
-				*(char **)(b+f->ofs) = G_NewString (value);
-				break;
-			case F_VECTOR:
-				Q_sscanf (value, "%f %f %f", &vec[0], &vec[1], &vec[2]);
-				((float *)(b+f->ofs))[0] = vec[0];
-				((float *)(b+f->ofs))[1] = vec[1];
-				((float *)(b+f->ofs))[2] = vec[2];
-				break;
-			case F_INT:
-				*(int *)(b+f->ofs) = atoi(value);
-				break;
-			case F_FLOAT:
-				*(float *)(b+f->ofs) = atof(value);
-				break;
-			case F_ANGLEHACK:
-				v = atof(value);
-				((float *)(b+f->ofs))[0] = 0;
-				((float *)(b+f->ofs))[1] = v;
-				((float *)(b+f->ofs))[2] = 0;
-				break;
-			default:
-			case F_IGNORE:
-				break;
-			}
-			return;
-		}
+	b = (byte *)ent;
+
+	switch( f->type ) {
+	case F_LSTRING:
+		*(char **)(b+f->ofs) = G_NewString (value);
+		break;
+	case F_ISTRING:
+		*(char **)(b+f->ofs) = G_InternString (value);
+		break;
+	case F_VECTOR:
+		Q_sscanf (value, "%f %f %f", &vec[0], &vec[1], &vec[2]);
+		((float *)(b+f->ofs))[0] = vec[0];
+		((float *)(b+f->ofs))[1] = vec[1];
+		((float *)(b+f->ofs))[2] = vec[2];
+		break;
+	case F_INT:
+		*(int *)(b+f->ofs) = atoi(value);
+		break;
+	case F_FLOAT:
+		*(float *)(b+f->ofs) = atof(value);
+		break;
+	case F_ANGLEHACK:
+		v = atof(value);
+		((float *)(b+f->ofs))[0] = 0;
+		((float *)(b+f->ofs))[1] = v;
+		((float *)(b+f->ofs))[2] = 0;
+		break;
+	default:
+	case F_IGNORE:
+		break;
 	}
 }
 
@@ -398,6 +567,10 @@ void G_SpawnGEntityFromSpawnVars( void ) {
 		G_ParseField( level.spawnVars[i][0], level.spawnVars[i][1], ent );
 	}
 
+	// the fields were written directly, bring the name index up to date
+	G_SetClassname( ent, ent->classname );
+	G_SetTargetname( ent, ent->targetname );
+
 	// check for "notsingle" flag
 	if ( g_gametype.integer == GT_SINGLE_PLAYER ) {
 		G_SpawnInt( "notsingle", "0", &i );
@@ -578,11 +751,11 @@ void SP_worldspawn( void ) {
 
 	g_entities[ENTITYNUM_WORLD].s.number = ENTITYNUM_WORLD;
 	g_entities[ENTITYNUM_WORLD].r.ownerNum = ENTITYNUM_NONE;
-	g_entities[ENTITYNUM_WORLD].classname = "worldspawn";
+	G_SetClassname( &g_entities[ENTITYNUM_WORLD], "worldspawn" );
 
 	g_entities[ENTITYNUM_NONE].s.number = ENTITYNUM_NONE;
 	g_entities[ENTITYNUM_NONE].r.ownerNum = ENTITYNUM_NONE;
-	g_entities[ENTITYNUM_NONE].classname = "nothing";
+	G_SetClassname( &g_entities[ENTITYNUM_NONE], "nothing" );
 
 	// see if we want a warmup time
 	if ( /*g_restarted.integer ||*/ g_gametype.integer == GT_SINGLE_PLAYER ) {
@@ -614,6 +787,11 @@ void G_SpawnEntitiesFromString( void ) {
 	level.spawning = qtrue;
 	level.numSpawnVars = 0;
 
+	// the pool was reset in G_InitGame
+	memset( internHash, 0, sizeof( internHash ) );
+	numInterned = 0;
+	G_InitSpawnHash();
+
 	// the worldspawn is not an actual entity, but it still
 	// has a "spawn" function to perform any global setup
 	// needed by a level (setting configstrings or cvars, etc)
@@ -10,7 +10,7 @@
 ==============================================================================
 
 PACKET FILTERING
- 
+
 
 You can add or remove addresses from the filter list with:
 
@@ -18,9 +18,11 @@ addip <ip>
 removeip <ip>
 
 The ip address is specified in dot format, and you can use '*' to match any value
-so you can specify an entire class C network with "addip 192.246.40.*"
+of the trailing parts so you can specify an entire class C network with "addip 192.246.40.*"
+CIDR notation ("addip 192.246.40.0/24") and IPv6 literals, with or without a
+prefix length ("addip 2001:db8::/32"), work as well.
 
-Removeip will only remove an address specified exactly the same way.  You cannot addip a subnet, then removeip a single host.
+Removeip will only remove a filter with the same address and prefix length ("192.246.40.*" and "192.246.40.0/24" are the same).  You cannot addip a subnet, then removeip a single host.
 
 listip
 Prints the current list of filters.
@@ -31,122 +33,449 @@ If 1 (the default), then ip addresses matching the current list will be prohibit
 
 If 0, then only addresses matching the list will be allowed.  This lets you easily set up a private game, or a game that only allows players from your local network.
 
-TTimo NOTE: for persistence, bans are stored in g_banIPs cvar MAX_CVAR_VALUE_STRING
-The size of the cvar string buffer is limiting the banning to around 20 masks
-this could be improved by putting some g_banIPs2 g_banIps3 etc. maybe
-still, you should rely on PB for banning instead
+Filters are kept in a compressed binary prefix trie of 128 bit addresses,
+IPv4 is mapped into ::ffff:0:0/96, so a lookup costs at most one node per
+distinct prefix length on the path instead of a scan of every filter.
+
+They are saved to the file named by g_banIPFile, one per line, written at
+the end of the frame they changed in. Filters still found in the old
+g_banIPs cvar are moved to the file when the game starts.
 
 ==============================================================================
 */
 
-typedef struct ipFilter_s
+#define	MAX_IPFILTERS		65536
+#define	MAX_IPFILTER_NODES	( MAX_IPFILTERS * 2 )
+
+typedef struct ipNode_s
 {
-	unsigned	mask;
-	unsigned	compare;
-} ipFilter_t;
+	unsigned	addr[4];		// prefix, bits past len are zero
+	int			child[2];		// 0 for none, the root is never a child
+	byte		len;			// prefix length in bits, 0..128
+	byte		filter;			// a filter ends at this node
+} ipNode_t;
+
+static ipNode_t		ipNodes[MAX_IPFILTER_NODES];	// ipNodes[0] is the root
+static int			numIPNodes;
+static int			freeIPNode;		// chained through child[0]
+static int			numIPFilters;
+static qboolean		ipFiltersChanged;
 
-#define	MAX_IPFILTERS	1024
+static int IPBit( const unsigned *addr, int bit )
+{
+	return ( addr[ bit >> 5 ] >> ( 31 - ( bit & 31 ) ) ) & 1;
+}
 
-static ipFilter_t	ipFilters[MAX_IPFILTERS];
-static int			numIPFilters;
+static void IPMask( unsigned *addr, int len )
+{
+	int		i, bits;
+
+	for ( i = 0 ; i < 4 ; i++ ) {
+		bits = len - i * 32;
+		if ( bits <= 0 )
+			addr[i] = 0;
+		else if ( bits < 32 )
+			addr[i] &= 0xffffffffu << ( 32 - bits );
+	}
+}
+
+static qboolean IPPrefixMatch( const unsigned *a, const unsigned *b, int len )
+{
+	int		i;
+
+	for ( i = 0 ; len >= 32 ; i++, len -= 32 ) {
+		if ( a[i] != b[i] )
+			return qfalse;
+	}
+	if ( len && ( ( a[i] ^ b[i] ) >> ( 32 - len ) ) )
+		return qfalse;
+	return qtrue;
+}
+
+static int IPCommonPrefix( const unsigned *a, const unsigned *b, int max )
+{
+	int			i, len;
+	unsigned	x;
+
+	for ( i = 0, len = 0 ; i < 4 && len < max ; i++, len += 32 ) {
+		x = a[i] ^ b[i];
+		if ( x ) {
+			while ( !( x & 0x80000000u ) ) {
+				x <<= 1;
+				len++;
+			}
+			break;
+		}
+	}
+	return len < max ? len : max;
+}
 
 /*
 =================
-StringToFilter
+ParseIPv4
+
+"a.b.c.d", fewer parts or trailing '*' parts make a shorter prefix
 =================
 */
-static qboolean StringToFilter (char *s, ipFilter_t *f)
+static const char *ParseIPv4( const char *s, unsigned *v, int *bits, qboolean wildcard )
 {
-	char	num[128];
-	int		i, j;
-	byte	b[4];
-	byte	m[4];
-	
-	for (i=0 ; i<4 ; i++)
-	{
-		b[i] = 0;
-		m[i] = 0;
-	}
-	
-	for (i=0 ; i<4 ; i++)
-	{
-		if (*s < '0' || *s > '9')
-		{
-			if (*s == '*') // 'match any'
-			{
-				// b[i] and m[i] to 0
-				s++;
-				if (!*s)
-					break;
-				s++;
-				continue;
-			}
-			G_Printf( "Bad filter address: %s\n", s );
-			return qfalse;
+	int			i, j, n;
+	qboolean	wild;
+
+	*v = 0;
+	*bits = 0;
+	wild = qfalse;		// only more wildcards may follow one
+	for ( i = 0 ; i < 4 ; i++ ) {
+		if ( *s == '*' && wildcard ) {
+			s++;
+			wild = qtrue;
+		} else if ( *s >= '0' && *s <= '9' && !wild ) {
+			for ( j = 0, n = 0 ; *s >= '0' && *s <= '9' ; j++, s++ )
+				n = n * 10 + *s - '0';
+			if ( j > 3 || n > 255 )
+				return NULL;
+			*v |= (unsigned)n << ( 24 - i * 8 );
+			*bits += 8;
+		} else {
+			return NULL;
 		}
-		
-		j = 0;
-		while (*s >= '0' && *s <= '9')
-		{
-			num[j++] = *s++;
+		if ( *s != '.' || i == 3 )
+			break;
+		s++;
+	}
+	return s;
+}
+
+static int HexValue( int c )
+{
+	if ( c >= '0' && c <= '9' )
+		return c - '0';
+	if ( c >= 'a' && c <= 'f' )
+		return c - 'a' + 10;
+	if ( c >= 'A' && c <= 'F' )
+		return c - 'A' + 10;
+	return -1;
+}
+
+/*
+=================
+ParseIPv6
+
+Eight colon separated groups, "::" once for a run of zero groups and
+optionally an IPv4 address as the last two
+=================
+*/
+static const char *ParseIPv6( const char *s, unsigned *addr )
+{
+	int			groups[8];
+	int			i, n, gap, g, bits;
+	unsigned	v;
+	const char	*p;
+
+	n = 0;
+	gap = -1;
+	if ( s[0] == ':' ) {
+		if ( s[1] != ':' )
+			return NULL;
+		gap = 0;
+		s += 2;
+	}
+
+	while ( n < 8 && HexValue( *s ) >= 0 ) {
+		for ( p = s ; HexValue( *p ) >= 0 ; p++ )
+			;
+		if ( *p == '.' ) {
+			if ( n > 6 )
+				return NULL;
+			s = ParseIPv4( s, &v, &bits, qfalse );
+			if ( !s || bits != 32 )
+				return NULL;
+			groups[n++] = v >> 16;
+			groups[n++] = v & 0xffff;
+			break;
 		}
-		num[j] = 0;
-		b[i] = atoi(num);
-		m[i] = 255;
+		if ( p - s > 4 )
+			return NULL;
+		for ( g = 0 ; s < p ; s++ )
+			g = g * 16 + HexValue( *s );
+		groups[n++] = g;
 
-		if (!*s)
+		if ( *s != ':' )
+			break;
+		if ( s[1] == ':' ) {
+			if ( gap >= 0 )
+				return NULL;
+			gap = n;
+			s += 2;
+		} else if ( HexValue( s[1] ) >= 0 ) {
+			s++;
+		} else {
 			break;
+		}
+	}
+
+	if ( gap < 0 ? n != 8 : n > 7 )
+		return NULL;
+
+	addr[0] = addr[1] = addr[2] = addr[3] = 0;
+	for ( i = 0 ; i < n ; i++ ) {
+		g = ( gap >= 0 && i >= gap ) ? i + 8 - n : i;
+		addr[ g >> 1 ] |= (unsigned)groups[i] << ( ( g & 1 ) ? 0 : 16 );
+	}
+	return s;
+}
+
+/*
+=================
+StringToFilter
+
+Parses an address into a 128 bit prefix. With port set it is a client
+address from the "ip" userinfo key, "a.b.c.d:port" or "[v6]:port",
+otherwise a filter with optional '*' parts or "/bits" prefix length.
+=================
+*/
+static qboolean StringToFilter( const char *s, unsigned *addr, int *len, qboolean port )
+{
+	const char	*p;
+	unsigned	v;
+	int			bits, max, n;
+	qboolean	bracket;
+
+	bracket = ( *s == '[' );
+	if ( bracket )
 		s++;
+
+	// IPv6 literals have at least two colons
+	p = strchr( s, ':' );
+	if ( bracket || ( p && strchr( p + 1, ':' ) ) ) {
+		s = ParseIPv6( s, addr );
+		if ( !s )
+			return qfalse;
+		if ( bracket ) {
+			if ( *s != ']' )
+				return qfalse;
+			s++;
+		}
+		*len = max = 128;
+	} else {
+		s = ParseIPv4( s, &v, &bits, !port );
+		if ( !s )
+			return qfalse;
+		addr[0] = addr[1] = 0;
+		addr[2] = 0xffff;
+		addr[3] = v;
+		*len = 96 + bits;
+		max = 32;
+	}
+
+	if ( port ) {
+		return ( !*s || *s == ':' ) ? qtrue : qfalse;
+	}
+
+	if ( *s == '/' && *len == 128 ) {
+		for ( s++, n = 0, bits = 0 ; *s >= '0' && *s <= '9' ; s++, n++ )
+			bits = bits * 10 + *s - '0';
+		if ( !n || n > 3 || bits > max )
+			return qfalse;
+		*len = 128 - max + bits;
 	}
-	
-	f->mask = *(unsigned *)m;
-	f->compare = *(unsigned *)b;
-	
+	if ( *s )
+		return qfalse;
+
+	IPMask( addr, *len );
 	return qtrue;
 }
 
+static void AppendHex( char *buf, int size, int v )
+{
+	char	hex[8];
+	int		n;
+
+	n = 0;
+	do {
+		hex[n++] = "0123456789abcdef"[ v & 15 ];
+		v >>= 4;
+	} while ( v );
+
+	for ( size -= strlen( buf ) + 1, buf += strlen( buf ) ; n && size > 0 ; size-- )
+		*buf++ = hex[--n];
+	*buf = '\0';
+}
+
 /*
 =================
-UpdateIPBans
+FilterToString
+
+IPv4 filters in dot format, others as compressed IPv6, "/bits" for
+everything but single hosts
 =================
 */
-static void UpdateIPBans (void)
+static void FilterToString( const unsigned *addr, int len, char *buf, int size )
 {
-	byte	b[4];
-	byte	m[4];
-	int		i,j;
-	char	iplist_final[MAX_CVAR_VALUE_STRING];
-	char	ip[64];
-
-	*iplist_final = 0;
-	for (i = 0 ; i < numIPFilters ; i++)
-	{
-		if (ipFilters[i].compare == 0xffffffff)
+	int		groups[8];
+	int		i, best, bestlen, run;
+
+	if ( len >= 96 && !addr[0] && !addr[1] && addr[2] == 0xffff ) {
+		Com_sprintf( buf, size, "%i.%i.%i.%i", addr[3] >> 24, ( addr[3] >> 16 ) & 255,
+			( addr[3] >> 8 ) & 255, addr[3] & 255 );
+		if ( len < 128 )
+			Q_strcat( buf, size, va( "/%i", len - 96 ) );
+		return;
+	}
+
+	// the longest run of zero groups is written as "::"
+	best = -1;
+	bestlen = 1;
+	for ( i = 0 ; i < 8 ; i++ ) {
+		groups[i] = ( addr[ i >> 1 ] >> ( ( i & 1 ) ? 0 : 16 ) ) & 0xffff;
+	}
+	for ( i = 0 ; i < 8 ; i += run ? run : 1 ) {
+		for ( run = 0 ; i + run < 8 && !groups[ i + run ] ; run++ )
+			;
+		if ( run > bestlen ) {
+			best = i;
+			bestlen = run;
+		}
+	}
+
+	buf[0] = '\0';
+	for ( i = 0 ; i < 8 ; ) {
+		if ( i == best ) {
+			Q_strcat( buf, size, "::" );
+			i += bestlen;
 			continue;
+		}
+		if ( i && i != best + bestlen )
+			Q_strcat( buf, size, ":" );
+		AppendHex( buf, size, groups[i] );
+		i++;
+	}
+	if ( len < 128 )
+		Q_strcat( buf, size, va( "/%i", len ) );
+}
+
+static int AllocIPNode( const unsigned *addr, int len )
+{
+	ipNode_t	*node;
+	int			n;
+
+	if ( freeIPNode ) {
+		n = freeIPNode;
+		freeIPNode = ipNodes[n].child[0];
+	} else {
+		n = numIPNodes++;
+	}
+
+	node = &ipNodes[n];
+	memcpy( node->addr, addr, sizeof( node->addr ) );
+	IPMask( node->addr, len );
+	node->len = len;
+	node->filter = qfalse;
+	node->child[0] = node->child[1] = 0;
+	return n;
+}
+
+static void FreeIPNode( int n )
+{
+	ipNodes[n].child[0] = freeIPNode;
+	freeIPNode = n;
+}
+
+static void ClearIPFilters( void )
+{
+	memset( &ipNodes[0], 0, sizeof( ipNodes[0] ) );
+	numIPNodes = 1;
+	freeIPNode = 0;
+	numIPFilters = 0;
+}
 
-		*(unsigned *)b = ipFilters[i].compare;
-		*(unsigned *)m = ipFilters[i].mask;
-		*ip = 0;
-		for (j = 0 ; j < 4 ; j++)
-		{
-			if (m[j]!=255)
-				Q_strcat(ip, sizeof(ip), "*");
-			else
-				Q_strcat(ip, sizeof(ip), va("%i", b[j]));
-			Q_strcat(ip, sizeof(ip), (j<3) ? "." : " ");
-		}		
-		if (strlen(iplist_final)+strlen(ip) < MAX_CVAR_VALUE_STRING)
-		{
-			Q_strcat( iplist_final, sizeof(iplist_final), ip);
+/*
+=================
+AddIPFilter
+
+Returns qfalse if the filter was already there
+=================
+*/
+static qboolean AddIPFilter( const unsigned *addr, int len )
+{
+	ipNode_t	*node, *c;
+	int			n, m, b, common;
+
+	for ( n = 0 ;; n = m ) {
+		node = &ipNodes[n];
+		if ( node->len == len ) {
+			if ( node->filter )
+				return qfalse;
+			node->filter = qtrue;
+			break;
 		}
-		else
-		{
-			Com_Printf("g_banIPs overflowed at MAX_CVAR_VALUE_STRING\n");
+
+		b = IPBit( addr, node->len );
+		m = node->child[b];
+		if ( !m ) {
+			m = AllocIPNode( addr, len );
+			ipNodes[m].filter = qtrue;
+			ipNodes[n].child[b] = m;
 			break;
 		}
+
+		c = &ipNodes[m];
+		common = IPCommonPrefix( addr, c->addr, len < c->len ? len : c->len );
+		if ( common == c->len )
+			continue;
+
+		// split the edge at the common prefix
+		n = AllocIPNode( addr, common );
+		ipNodes[n].child[ IPBit( c->addr, common ) ] = m;
+		node->child[b] = n;
+		if ( common == len ) {
+			ipNodes[n].filter = qtrue;
+		} else {
+			m = AllocIPNode( addr, len );
+			ipNodes[m].filter = qtrue;
+			ipNodes[n].child[ IPBit( addr, common ) ] = m;
+		}
+		break;
 	}
 
-	trap_Cvar_Set( "g_banIPs", iplist_final );
+	numIPFilters++;
+	ipFiltersChanged = qtrue;
+	return qtrue;
+}
+
+/*
+=================
+RemoveIPFilter
+
+Returns what takes the place of node n, nodes left without a filter
+and with less than two children are merged away
+=================
+*/
+static int RemoveIPFilter( int n, const unsigned *addr, int len, qboolean *removed )
+{
+	ipNode_t	*node;
+	int			b, c;
+
+	node = &ipNodes[n];
+	if ( node->len == len ) {
+		if ( !node->filter )
+			return n;
+		node->filter = qfalse;
+		*removed = qtrue;
+	} else {
+		b = IPBit( addr, node->len );
+		c = node->child[b];
+		if ( !c || ipNodes[c].len > len || !IPPrefixMatch( addr, ipNodes[c].addr, ipNodes[c].len ) )
+			return n;
+		node->child[b] = RemoveIPFilter( c, addr, len, removed );
+	}
+
+	if ( !n || node->filter || ( node->child[0] && node->child[1] ) )
+		return n;
+
+	c = node->child[0] ? node->child[0] : node->child[1];
+	FreeIPNode( n );
+	return c;
 }
 
 /*
@@ -156,29 +485,21 @@ G_FilterPacket
 */
 qboolean G_FilterPacket (char *from)
 {
-	int		i;
-	unsigned	in;
-	byte m[4];
-	char *p;
-
-	i = 0;
-	p = from;
-	while (*p && i < 4) {
-		m[i] = 0;
-		while (*p >= '0' && *p <= '9') {
-			m[i] = m[i]*10 + (*p - '0');
-			p++;
+	unsigned	addr[4];
+	ipNode_t	*node;
+	int			len, c;
+
+	if ( StringToFilter( from, addr, &len, qtrue ) ) {
+		for ( node = ipNodes ;; node = &ipNodes[c] ) {
+			if ( node->filter )
+				return g_filterBan.integer != 0;
+			if ( node->len >= len )
+				break;
+			c = node->child[ IPBit( addr, node->len ) ];
+			if ( !c || !IPPrefixMatch( addr, ipNodes[c].addr, ipNodes[c].len ) )
+				break;
 		}
-		if (!*p || *p == ':')
-			break;
-		i++, p++;
 	}
-	
-	in = *(unsigned *)m;
-
-	for (i=0 ; i<numIPFilters ; i++)
-		if ( (in & ipFilters[i].mask) == ipFilters[i].compare)
-			return g_filterBan.integer != 0;
 
 	return g_filterBan.integer == 0;
 }
@@ -188,27 +509,151 @@ qboolean G_FilterPacket (char *from)
 AddIP
 =================
 */
-static void AddIP( char *str )
+static void AddIP( const char *str )
 {
-	int		i;
+	unsigned	addr[4];
+	int			len;
+
+	if ( !StringToFilter( str, addr, &len, qfalse ) ) {
+		G_Printf( "Bad filter address: %s\n", str );
+		return;
+	}
+
+	if ( numIPFilters >= MAX_IPFILTERS || numIPNodes + 2 > MAX_IPFILTER_NODES ) {
+		G_Printf ("IP filter list is full\n");
+		return;
+	}
+
+	AddIPFilter( addr, len );
+}
+
+/*
+=================
+WriteIPFilters
 
-	for (i = 0 ; i < numIPFilters ; i++)
-		if (ipFilters[i].compare == 0xffffffff)
-			break;		// free spot
-	if (i == numIPFilters)
-	{
-		if (numIPFilters == MAX_IPFILTERS)
-		{
-			G_Printf ("IP filter list is full\n");
-			return;
+Walks the trie in address order, printing the filters or writing them
+to f through buf
+=================
+*/
+static void WriteIPFilters( int n, fileHandle_t f, char *buf, int *buflen, int size )
+{
+	ipNode_t	*node;
+	char		line[64];
+	int			len;
+
+	node = &ipNodes[n];
+	if ( node->filter ) {
+		FilterToString( node->addr, node->len, line, sizeof( line ) );
+		if ( f == FS_INVALID_HANDLE ) {
+			G_Printf( "%s\n", line );
+		} else {
+			len = strlen( line );
+			if ( *buflen + len + 1 > size ) {
+				trap_FS_Write( buf, *buflen, f );
+				*buflen = 0;
+			}
+			memcpy( buf + *buflen, line, len );
+			buf[ *buflen + len ] = '\n';
+			*buflen += len + 1;
 		}
-		numIPFilters++;
 	}
-	
-	if (!StringToFilter (str, &ipFilters[i]))
-		ipFilters[i].compare = 0xffffffffu;
 
-	UpdateIPBans();
+	if ( node->child[0] )
+		WriteIPFilters( node->child[0], f, buf, buflen, size );
+	if ( node->child[1] )
+		WriteIPFilters( node->child[1], f, buf, buflen, size );
+}
+
+/*
+=================
+G_SaveIPBans
+
+Writes g_banIPFile if the filters changed, called at the end of every
+frame so a script adding thousands of filters writes the file once
+=================
+*/
+void G_SaveIPBans( void )
+{
+	static char		buf[8192];
+	fileHandle_t	f;
+	int				len;
+
+	if ( !ipFiltersChanged )
+		return;
+	ipFiltersChanged = qfalse;
+
+	if ( !g_banIPFile.string[0] )
+		return;
+
+	if ( trap_FS_FOpenFile( g_banIPFile.string, &f, FS_WRITE ) < 0 || f == FS_INVALID_HANDLE ) {
+		G_Printf( "Couldn't write %s\n", g_banIPFile.string );
+		return;
+	}
+
+	len = 0;
+	WriteIPFilters( 0, f, buf, &len, sizeof( buf ) );
+	if ( len )
+		trap_FS_Write( buf, len, f );
+	trap_FS_FCloseFile( f );
+}
+
+/*
+=================
+LoadIPBans
+
+One filter per line, empty lines and lines starting with '#' or "//"
+are skipped
+=================
+*/
+static void LoadIPBans( void )
+{
+	static char		buf[8192];
+	fileHandle_t	f;
+	int				len, chunk, used, start, i;
+
+	if ( !g_banIPFile.string[0] )
+		return;
+
+	len = trap_FS_FOpenFile( g_banIPFile.string, &f, FS_READ );
+	if ( f == FS_INVALID_HANDLE )
+		return;
+
+	used = 0;
+	while ( len > 0 || used ) {
+		chunk = sizeof( buf ) - 1 - used;
+		if ( chunk > len )
+			chunk = len;
+		if ( chunk > 0 ) {
+			trap_FS_Read( buf + used, chunk, f );
+			used += chunk;
+			len -= chunk;
+		}
+		if ( !len )
+			buf[ used++ ] = '\n';	// the last line may have no newline
+
+		start = 0;
+		for ( i = 0 ; i < used ; i++ ) {
+			if ( buf[i] != '\n' && buf[i] != '\r' )
+				continue;
+			buf[i] = '\0';
+			while ( buf[start] == ' ' || buf[start] == '\t' )
+				start++;
+			if ( buf[start] && buf[start] != '#' && ( buf[start] != '/' || buf[start + 1] != '/' ) )
+				AddIP( buf + start );
+			start = i + 1;
+		}
+
+		if ( !len )
+			break;
+		if ( !start ) {
+			G_Printf( "%s: line too long\n", g_banIPFile.string );
+			break;
+		}
+		used -= start;
+		memmove( buf, buf + start, used );
+	}
+
+	trap_FS_FCloseFile( f );
 }
 
 /*
@@ -216,23 +661,36 @@ static void AddIP( char *str )
 G_ProcessIPBans
 =================
 */
-void G_ProcessIPBans(void) 
+void G_ProcessIPBans(void)
 {
 	char *s, *t;
 	char		str[MAX_CVAR_VALUE_STRING];
 
+	ClearIPFilters();
+	LoadIPBans();
+
+	// move filters from the old g_banIPs cvar to the file
 	Q_strncpyz( str, g_banIPs.string, sizeof(str) );
 
-	for (t = s = g_banIPs.string; *t; /* */ ) {
+	for (t = s = str; *t; /* */ ) {
 		s = strchr(s, ' ');
-		if (!s)
-			break;
-		while (*s == ' ')
-			*s++ = 0;
+		if (s) {
+			while (*s == ' ')
+				*s++ = 0;
+		}
 		if (*t)
 			AddIP( t );
+		if (!s)
+			break;
 		t = s;
 	}
+
+	if ( str[0] && g_banIPFile.string[0] ) {
+		trap_Cvar_Set( "g_banIPs", "" );
+		ipFiltersChanged = qtrue;
+	} else {
+		ipFiltersChanged = qfalse;
+	}
 }
 
 
@@ -263,8 +721,9 @@ Svcmd_RemoveIP_f
 */
 void Svcmd_RemoveIP_f (void)
 {
-	ipFilter_t	f;
-	int			i;
+	unsigned	addr[4];
+	int			len;
+	qboolean	removed;
 	char		str[MAX_TOKEN_CHARS];
 
 	if ( trap_Argc() < 2 ) {
@@ -274,23 +733,37 @@ void Svcmd_RemoveIP_f (void)
 
 	trap_Argv( 1, str, sizeof( str ) );
 
-	if (!StringToFilter (str, &f))
+	if ( !StringToFilter( str, addr, &len, qfalse ) ) {
+		G_Printf( "Bad filter address: %s\n", str );
 		return;
+	}
 
-	for (i=0 ; i<numIPFilters ; i++) {
-		if (ipFilters[i].mask == f.mask	&&
-			ipFilters[i].compare == f.compare) {
-			ipFilters[i].compare = 0xffffffffu;
-			G_Printf ("Removed.\n");
-
-			UpdateIPBans();
-			return;
-		}
+	removed = qfalse;
+	RemoveIPFilter( 0, addr, len, &removed );
+	if ( removed ) {
+		numIPFilters--;
+		ipFiltersChanged = qtrue;
+		G_Printf ("Removed.\n");
+		return;
 	}
 
 	G_Printf ( "Didn't find %s.\n", str );
 }
 
+/*
+=================
+Svcmd_ListIP_f
+=================
+*/
+void Svcmd_ListIP_f (void)
+{
+	int		len;
+
+	len = 0;
+	WriteIPFilters( 0, FS_INVALID_HANDLE, NULL, &len, 0 );
+	G_Printf( "%i of %i filters\n", numIPFilters, MAX_IPFILTERS );
+}
+
 /*
 ===================
 Svcmd_EntityList_f
@@ -465,6 +938,11 @@ qboolean	ConsoleCommand( void ) {
 		return qtrue;
 	}
 
+	if ( Q_stricmp (cmd, "entitystats") == 0 ) {
+		Svcmd_EntityStats_f();
+		return qtrue;
+	}
+
 	if ( Q_stricmp (cmd, "forceteam") == 0 ) {
 		Svcmd_ForceTeam_f();
 		return qtrue;
@@ -485,6 +963,11 @@ qboolean	ConsoleCommand( void ) {
 		return qtrue;
 	}
 
+	if (Q_stricmp (cmd, "botentities") == 0) {
+		Svcmd_BotEntities_f();
+		return qtrue;
+	}
+
 	if (Q_stricmp (cmd, "abort_podium") == 0) {
 		Svcmd_AbortPodium_f();
 		return qtrue;
@@ -501,7 +984,7 @@ qboolean	ConsoleCommand( void ) {
 	}
 
 	if (Q_stricmp (cmd, "listip") == 0) {
-		trap_SendConsoleCommand( EXEC_NOW, "g_banIPs\n" );
+		Svcmd_ListIP_f();
 		return qtrue;
 	}
 
@@ -510,6 +993,11 @@ qboolean	ConsoleCommand( void ) {
 		return qtrue;
 	}
 
+	if (Q_stricmp (cmd, "profile") == 0) {
+		Svcmd_Profile_f();
+		return qtrue;
+	}
+
 	if (g_dedicated.integer) {
 		if (Q_stricmp (cmd, "say") == 0) {
 			char *msg = ConcatArgs(1);
@@ -8,6 +8,13 @@
 #error "Do not use in VM build"
 #endif
 
+// the g_profile counting wrappers from g_local.h
+#undef trap_Trace
+#undef trap_TraceCapsule
+#undef trap_LinkEntity
+#undef trap_EntitiesInBox
+#undef trap_SendServerCommand
+
 static dllSyscall_t syscall = (dllSyscall_t)-1;
 
 DLLEXPORT void dllEntry( dllSyscall_t syscallptr ) {
@@ -772,3 +779,7 @@ int trap_PC_SourceFileAndLine( int handle, char *filename, int *line ) {
 qboolean trap_GetValue( char *value, int valueSize, const char *key ) {
 	return syscall( dll_com_trapGetValue, value, valueSize, key );
 }
+
+int trap_Microseconds( void ) {
+	return syscall( dll_trap_Microseconds );
+}
@@ -435,6 +435,7 @@ static void target_location_linkup(gentity_t *ent)
 	}
 
 	// All linked together now
+	Team_InitLocations();
 }
 
 /*QUAKED target_location (0 0.5 0) (-8 -8 -8) (8 8 8)
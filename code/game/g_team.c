@@ -137,6 +137,7 @@ void AddTeamScore( vec3_t origin, team_t team, int score ) {
 	}
 
 	level.teamScores[ team ] += score;
+	level.scoreboardValid = qfalse;
 }
 
 /*
@@ -954,30 +955,196 @@ int Pickup_Team( gentity_t *ent, gentity_t *other ) {
 }
 
 
+#define LOCATION_GRID_ENTRIES	4096	// cells * locations
+#define LOCATION_GRID_MINCELL	64.0f
+
+// every cell holds all locations sorted by distance from the cell center,
+// so a lookup can stop as soon as the triangle inequality rules out the rest
+typedef struct locationGrid_s {
+	int			numLocations;
+	gentity_t	**locations;		// in level.locationHead order
+	int			cells[2];
+	float		cellSize;
+	vec3_t		mins;
+	float		centerZ;
+	short		*order;				// [cell][numLocations]
+	float		*distance;			// distance from the cell center, same layout
+} locationGrid_t;
+
+static const float	*locationSortDistance;
+
+static int QDECL Team_SortLocations( const void *a, const void *b ) {
+	int		ia = *(const short *)a;
+	int		ib = *(const short *)b;
+
+	if ( locationSortDistance[ ia ] < locationSortDistance[ ib ] ) {
+		return -1;
+	}
+	if ( locationSortDistance[ ia ] > locationSortDistance[ ib ] ) {
+		return 1;
+	}
+	return ia - ib;
+}
+
+
 /*
 ===========
-Team_GetLocation
+Team_InitLocations
 
-Report a location for the player. Uses placed nearby target_location entities
+Builds the location grid once the target_locations are linked
 ============
 */
-gentity_t *Team_GetLocation(gentity_t *ent)
-{
+void Team_InitLocations( void ) {
+	static float	dist[LOCATION_GRID_ENTRIES];
+	locationGrid_t	*grid;
+	gentity_t		*eloc;
+	vec3_t			mins, maxs, center;
+	float			size, extent[2];
+	int				i, n, x, y, cell, maxCells;
+	short			*order;
+
+	level.locationGrid = NULL;
+
+	n = 0;
+	for ( eloc = level.locationHead; eloc; eloc = eloc->nextTrain ) {
+		n++;
+	}
+	if ( !n || n > LOCATION_GRID_ENTRIES ) {
+		return;
+	}
+
+	grid = G_Alloc( sizeof( *grid ) );
+	grid->numLocations = n;
+	grid->locations = G_Alloc( n * sizeof( grid->locations[0] ) );
+
+	ClearBounds( mins, maxs );
+	for ( i = 0, eloc = level.locationHead; eloc; eloc = eloc->nextTrain, i++ ) {
+		grid->locations[ i ] = eloc;
+		AddPointToBounds( eloc->r.currentOrigin, mins, maxs );
+	}
+
+	// square cells, as many as the entry budget allows
+	maxCells = LOCATION_GRID_ENTRIES / n;
+	extent[0] = maxs[0] - mins[0];
+	extent[1] = maxs[1] - mins[1];
+	size = sqrt( extent[0] * extent[1] / maxCells );
+	if ( size < LOCATION_GRID_MINCELL ) {
+		size = LOCATION_GRID_MINCELL;
+	}
+	for ( ;; ) {
+		grid->cells[0] = (int)( extent[0] / size ) + 1;
+		grid->cells[1] = (int)( extent[1] / size ) + 1;
+		if ( grid->cells[0] * grid->cells[1] <= maxCells ) {
+			break;
+		}
+		size *= 1.125f;
+	}
+
+	grid->cellSize = size;
+	VectorCopy( mins, grid->mins );
+	grid->centerZ = ( mins[2] + maxs[2] ) * 0.5f;
+
+	cell = grid->cells[0] * grid->cells[1];
+	grid->order = G_Alloc( cell * n * sizeof( grid->order[0] ) );
+	grid->distance = G_Alloc( cell * n * sizeof( grid->distance[0] ) );
+
+	locationSortDistance = dist;
+	for ( y = 0; y < grid->cells[1]; y++ ) {
+		for ( x = 0; x < grid->cells[0]; x++ ) {
+			cell = y * grid->cells[0] + x;
+			order = grid->order + cell * n;
+
+			center[0] = mins[0] + ( x + 0.5f ) * size;
+			center[1] = mins[1] + ( y + 0.5f ) * size;
+			center[2] = grid->centerZ;
+
+			for ( i = 0; i < n; i++ ) {
+				dist[ i ] = Distance( center, grid->locations[ i ]->r.currentOrigin );
+				order[ i ] = i;
+			}
+			qsort( order, n, sizeof( order[0] ), Team_SortLocations );
+			for ( i = 0; i < n; i++ ) {
+				grid->distance[ cell * n + i ] = dist[ order[ i ] ];
+			}
+		}
+	}
+
+	level.locationGrid = grid;
+}
+
+
+/*
+===========
+Team_FindLocation
+
+Closest target_location in the PVS of origin. Gives the same answer as
+walking level.locationHead, ties included.
+============
+*/
+static gentity_t *Team_FindLocation( const vec3_t origin ) {
+	locationGrid_t	*grid;
 	gentity_t		*eloc, *best;
-	float			bestlen, len;
-	vec3_t			origin;
+	float			bestlen, len, bound, radius;
+	vec3_t			center;
+	int				i, k, x, y, n, besti;
+	const short		*order;
+	const float		*distance;
 
 	best = NULL;
 	bestlen = 3*8192.0*8192.0;
 
-	VectorCopy( ent->r.currentOrigin, origin );
+	grid = level.locationGrid;
+	if ( !grid ) {
+		for (eloc = level.locationHead; eloc; eloc = eloc->nextTrain) {
+			len = ( origin[0] - eloc->r.currentOrigin[0] ) * ( origin[0] - eloc->r.currentOrigin[0] )
+				+ ( origin[1] - eloc->r.currentOrigin[1] ) * ( origin[1] - eloc->r.currentOrigin[1] )
+				+ ( origin[2] - eloc->r.currentOrigin[2] ) * ( origin[2] - eloc->r.currentOrigin[2] );
+
+			if ( len > bestlen ) {
+				continue;
+			}
+
+			if ( !trap_InPVS( origin, eloc->r.currentOrigin ) ) {
+				continue;
+			}
+
+			bestlen = len;
+			best = eloc;
+		}
+		return best;
+	}
+
+	x = (int)floor( ( origin[0] - grid->mins[0] ) / grid->cellSize );
+	y = (int)floor( ( origin[1] - grid->mins[1] ) / grid->cellSize );
+	x = x < 0 ? 0 : ( x >= grid->cells[0] ? grid->cells[0] - 1 : x );
+	y = y < 0 ? 0 : ( y >= grid->cells[1] ? grid->cells[1] - 1 : y );
+
+	center[0] = grid->mins[0] + ( x + 0.5f ) * grid->cellSize;
+	center[1] = grid->mins[1] + ( y + 0.5f ) * grid->cellSize;
+	center[2] = grid->centerZ;
+	radius = Distance( origin, center );
 
-	for (eloc = level.locationHead; eloc; eloc = eloc->nextTrain) {
+	n = grid->numLocations;
+	order = grid->order + ( y * grid->cells[0] + x ) * n;
+	distance = grid->distance + ( y * grid->cells[0] + x ) * n;
+	besti = -1;
+
+	for ( k = 0; k < n; k++ ) {
+		// no location further down the list can be closer,
+		// the slack keeps float rounding from pruning a tie
+		bound = distance[ k ] - radius;
+		if ( bound > 0 && bound * bound > bestlen * 1.001f + 1.0f ) {
+			break;
+		}
+
+		i = order[ k ];
+		eloc = grid->locations[ i ];
 		len = ( origin[0] - eloc->r.currentOrigin[0] ) * ( origin[0] - eloc->r.currentOrigin[0] )
 			+ ( origin[1] - eloc->r.currentOrigin[1] ) * ( origin[1] - eloc->r.currentOrigin[1] )
 			+ ( origin[2] - eloc->r.currentOrigin[2] ) * ( origin[2] - eloc->r.currentOrigin[2] );
 
-		if ( len > bestlen ) {
+		// the list walk lets the later of two equally close locations win
+		if ( len > bestlen || ( len == bestlen && i < besti ) ) {
 			continue;
 		}
 
@@ -987,12 +1154,43 @@ gentity_t *Team_GetLocation(gentity_t *ent)
 
 		bestlen = len;
 		best = eloc;
+		besti = i;
 	}
 
 	return best;
 }
 
 
+/*
+===========
+Team_GetLocation
+
+Report a location for the player. Uses placed nearby target_location entities
+============
+*/
+gentity_t *Team_GetLocation(gentity_t *ent)
+{
+	gclient_t	*client;
+
+	client = ent->client;
+	if ( !client ) {
+		return Team_FindLocation( ent->r.currentOrigin );
+	}
+
+	// the answer only changes with the position or the areaportal state
+	if ( !client->location.valid || !VectorCompare( ent->r.currentOrigin, client->location.origin )
+		|| client->location.portals != level.areaPortalChanges || client->location.head != level.locationHead ) {
+		client->location.valid = qtrue;
+		VectorCopy( ent->r.currentOrigin, client->location.origin );
+		client->location.portals = level.areaPortalChanges;
+		client->location.head = level.locationHead;
+		client->location.loc = Team_FindLocation( ent->r.currentOrigin );
+	}
+
+	return client->location.loc;
+}
+
+
 /*
 ===========
 Team_GetLocation
@@ -1194,55 +1392,44 @@ gentity_t *SelectCTFSpawnPoint( gentity_t *ent, team_t team, int teamstate, vec3
 
 /*---------------------------------------------------------------------------*/
 
-static int QDECL SortClients( const void *a, const void *b ) {
-	return *(int *)a - *(int *)b;
-}
+#define TEAM_INFO_REFRESH_TIME	10000	// resend unchanged overlays, cgame may have restarted
+
+typedef struct {
+	int		seq;				// changes whenever the message does, 0 for none
+	char	message[ MAX_STRING_CHARS ];
+} teamInfo_t;
+
+static teamInfo_t	teamInfos[ TEAM_NUM_TEAMS ];
+static int			teamInfoSeq;	// shared by all teams so a team change always resends
 
 
 /*
 ==================
-TeamplayLocationsMessage
+BuildTeamplayInfo
 
 Format:
 	clientNum location health armor weapon powerups
 
+The first eight players of the team in client order, built once per team
+and only given a new sequence when some field changed
 ==================
 */
-void TeamplayInfoMessage( gentity_t *ent ) {
+static void BuildTeamplayInfo( team_t team ) {
 	char		entry[ 128 ]; // to fit 6 decimal numbers with spaces
 	char		string[ MAX_STRING_CHARS - 9 ]; // -strlen("tinfo nn ")
+	char		message[ MAX_STRING_CHARS ];
 	int			stringlength;
 	int			i, j;
 	gentity_t	*player;
 	int			cnt;
 	int			h, a;
-	int			clients[TEAM_MAXOVERLAY];
-
-	if ( !ent->client->pers.teamInfo )
-		return;
 
-	// figure out what client should be on the display
-	// we are limited to 8, but we want to use the top eight players
-	// but in client order (so they don't keep changing position on the overlay)
-	for (i = 0, cnt = 0; i < level.maxclients && cnt < TEAM_MAXOVERLAY; i++) {
-		player = g_entities + level.sortedClients[i];
-		if (player->inuse && player->client->sess.sessionTeam ==
-			ent->client->sess.sessionTeam ) {
-			clients[cnt++] = level.sortedClients[i];
-		}
-	}
-
-	// We have the top eight players, sort them by clientNum
-	qsort( clients, cnt, sizeof( clients[0] ), SortClients );
-
-	// send the latest information on all clients
 	string[0] = '\0';
 	stringlength = 0;
 
 	for (i = 0, cnt = 0; i < level.maxclients && cnt < TEAM_MAXOVERLAY; i++) {
 		player = g_entities + i;
-		if ( player->inuse && player->client->sess.sessionTeam ==
-			ent->client->sess.sessionTeam ) {
+		if ( player->inuse && player->client->sess.sessionTeam == team ) {
 
 			h = player->client->ps.stats[STAT_HEALTH];
 			a = player->client->ps.stats[STAT_ARMOR];
@@ -1250,7 +1437,6 @@ void TeamplayInfoMessage( gentity_t *ent ) {
 			if (a < 0) a = 0;
 
 			j = BG_sprintf( entry, " %i %i %i %i %i %i",
-//				level.sortedClients[i], player->client->pers.teamState.location, h, a, 
 				i, player->client->pers.teamState.location, h, a, 
 				player->client->ps.weapon, player->s.powerups);
 			if ( stringlength + j >= sizeof( string ) )
@@ -1261,15 +1447,67 @@ void TeamplayInfoMessage( gentity_t *ent ) {
 		}
 	}
 
-	trap_SendServerCommand( ent-g_entities, va( "tinfo %i %s", cnt, string ) );
+	Com_sprintf( message, sizeof( message ), "tinfo %i %s", cnt, string );
+
+	if ( !teamInfos[ team ].seq || strcmp( message, teamInfos[ team ].message ) ) {
+		Q_strncpyz( teamInfos[ team ].message, message, sizeof( teamInfos[ team ].message ) );
+		teamInfos[ team ].seq = ++teamInfoSeq;
+	}
+}
+
+
+/*
+==================
+TeamplayInfoMessage
+
+Sends the team overlay if it changed since the client last got it
+==================
+*/
+void TeamplayInfoMessage( gentity_t *ent ) {
+	gclient_t	*client;
+	teamInfo_t	*info;
+
+	client = ent->client;
+	if ( !client->pers.teamInfo ) {
+		client->pers.teamInfoSeq = 0;
+		return;
+	}
+
+	info = &teamInfos[ client->sess.sessionTeam ];
+	if ( !info->seq ) {
+		return;
+	}
+
+	if ( client->pers.teamInfoSeq == info->seq
+		&& level.time - client->pers.teamInfoTime < TEAM_INFO_REFRESH_TIME ) {
+		return;
+	}
+
+	client->pers.teamInfoSeq = info->seq;
+	client->pers.teamInfoTime = level.time;
+	trap_SendServerCommand( ent-g_entities, info->message );
 }
 
 
+/*
+==================
+CheckTeamStatus
+
+Updates locations and overlays every g_teamInfoTime msec, since only
+changed overlays go out this can be well below the old fixed second
+==================
+*/
 void CheckTeamStatus( void ) {
 	int i;
 	gentity_t *loc, *ent;
+	int interval;
 
-	if (level.time - level.lastTeamLocationTime > TEAM_LOCATION_UPDATE_TIME) {
+	interval = g_teamInfoTime.integer;
+	if ( interval < 50 ) {
+		interval = 50;
+	}
+
+	if (level.time - level.lastTeamLocationTime > interval) {
 
 		level.lastTeamLocationTime = level.time;
 
@@ -1289,6 +1527,9 @@ void CheckTeamStatus( void ) {
 			}
 		}
 
+		BuildTeamplayInfo( TEAM_RED );
+		BuildTeamplayInfo( TEAM_BLUE );
+
 		for (i = 0; i < level.maxclients; i++) {
 			ent = g_entities + i;
 
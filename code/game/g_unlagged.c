@@ -74,18 +74,17 @@ static void TimeShiftLerp( float frac, const vec3_t start, const vec3_t end, vec
 
 /*
 =================
-G_TimeShiftClient
+G_TimeShiftTarget
 
-Move a client back to where he was at the specified "time"
+Find where a client was at the specified "time", returns qfalse
+if the client doesn't need to be moved at all
 =================
 */
-void G_TimeShiftClient( gentity_t *ent, int time, qboolean debug, gentity_t *debugger ) {
+static qboolean G_TimeShiftTarget( const gclient_t *client, int time, vec3_t origin, vec3_t mins, vec3_t maxs ) {
 	int		j, k;
-	gclient_t	*client;
 
 	// find two entries in the history whose times sandwich "time"
 	// assumes no two adjacent records have the same timestamp
-	client = ent->client;
 	j = k = client->historyHead;
 	do {
 		if ( client->history[j].leveltime <= time )
@@ -99,42 +98,77 @@ void G_TimeShiftClient( gentity_t *ent, int time, qboolean debug, gentity_t *deb
 	}
 	while ( j != client->historyHead );
 
-	// if we got past the first iteration above, we've sandwiched (or wrapped)
-	if ( j != k ) {
-		// make sure it doesn't get re-saved
-		if ( client->saved.leveltime != level.time ) {
-			// save the current origin and bounding box
-			VectorCopy( ent->r.mins, client->saved.mins );
-			VectorCopy( ent->r.maxs, client->saved.maxs );
-			VectorCopy( ent->r.currentOrigin, client->saved.currentOrigin );
-			client->saved.leveltime = level.time;
-		}
+	// if we didn't get past the first iteration above, he's already there
+	if ( j == k ) {
+		return qfalse;
+	}
+
+	// if we haven't wrapped back to the head, we've sandwiched, so
+	// we shift the client's position back to where he was at "time"
+	if ( j != client->historyHead ) {
+		float	frac = (float)(time - client->history[j].leveltime) /
+			(float)(client->history[k].leveltime - client->history[j].leveltime);
 
-		// if we haven't wrapped back to the head, we've sandwiched, so
-		// we shift the client's position back to where he was at "time"
-		if ( j != client->historyHead ) {
-			float	frac = (float)(time - client->history[j].leveltime) /
-				(float)(client->history[k].leveltime - client->history[j].leveltime);
+		// interpolate between the two origins to give position at time index "time"
+		TimeShiftLerp( frac, client->history[j].currentOrigin, client->history[k].currentOrigin, origin );
 
-			// interpolate between the two origins to give position at time index "time"
-			TimeShiftLerp( frac, client->history[j].currentOrigin, client->history[k].currentOrigin, ent->r.currentOrigin );
+		// lerp these too, just for fun (and ducking)
+		TimeShiftLerp( frac, client->history[j].mins, client->history[k].mins, mins );
 
-			// lerp these too, just for fun (and ducking)
-			TimeShiftLerp( frac, client->history[j].mins, client->history[k].mins, ent->r.mins );
+		TimeShiftLerp( frac, client->history[j].maxs, client->history[k].maxs, maxs );
+	} else {
+		// we wrapped, so grab the earliest
+		VectorCopy( client->history[k].currentOrigin, origin );
+		VectorCopy( client->history[k].mins, mins );
+		VectorCopy( client->history[k].maxs, maxs );
+	}
 
-			TimeShiftLerp( frac, client->history[j].maxs, client->history[k].maxs,ent->r.maxs );
+	return qtrue;
+}
 
-			// this will recalculate absmin and absmax
-			trap_LinkEntity( ent );
-		} else {
-			// we wrapped, so grab the earliest
-			VectorCopy( client->history[k].currentOrigin, ent->r.currentOrigin );
-			VectorCopy( client->history[k].mins, ent->r.mins );
-			VectorCopy( client->history[k].maxs, ent->r.maxs );
 
-			// this will recalculate absmin and absmax
-			trap_LinkEntity( ent );
-		}
+/*
+=================
+G_TimeShiftApply
+
+Save the current position (once per frame) and relink at the shifted one
+=================
+*/
+static void G_TimeShiftApply( gentity_t *ent, const vec3_t origin, const vec3_t mins, const vec3_t maxs ) {
+	gclient_t	*client;
+
+	client = ent->client;
+
+	// make sure it doesn't get re-saved
+	if ( client->saved.leveltime != level.time ) {
+		// save the current origin and bounding box
+		VectorCopy( ent->r.mins, client->saved.mins );
+		VectorCopy( ent->r.maxs, client->saved.maxs );
+		VectorCopy( ent->r.currentOrigin, client->saved.currentOrigin );
+		client->saved.leveltime = level.time;
+	}
+
+	VectorCopy( origin, ent->r.currentOrigin );
+	VectorCopy( mins, ent->r.mins );
+	VectorCopy( maxs, ent->r.maxs );
+
+	// this will recalculate absmin and absmax
+	trap_LinkEntity( ent );
+}
+
+
+/*
+=================
+G_TimeShiftClient
+
+Move a client back to where he was at the specified "time"
+=================
+*/
+void G_TimeShiftClient( gentity_t *ent, int time, qboolean debug, gentity_t *debugger ) {
+	vec3_t	origin, mins, maxs;
+
+	if ( G_TimeShiftTarget( ent->client, time, origin, mins, maxs ) ) {
+		G_TimeShiftApply( ent, origin, mins, maxs );
 	}
 }
 
@@ -167,14 +201,129 @@ void G_TimeShiftAllClients( int ltime, gentity_t *skip ) {
 }
 
 
+/*
+=====================
+G_ShotMayHit
+
+Conservative test of a shot against an axial box, the shot is the segment
+"start" + t * "dir" for t in [0, length] widened into a cone with "spread"
+units of lateral deviation per unit of distance
+=====================
+*/
+static qboolean G_ShotMayHit( const vec3_t start, const vec3_t dir, float length, float spread, const vec3_t boxmin, const vec3_t boxmax ) {
+	vec3_t	mins, maxs;
+	float	pad, enter, leave, t1, t2;
+	int		i;
+
+	// one unit for the engine's link epsilon, the rest covers
+	// the cone radius at the farthest point of the box
+	pad = 1.0f;
+	if ( spread > 0.0f ) {
+		vec3_t	center;
+		float	dist;
+
+		for ( i = 0; i < 3; i++ ) {
+			center[i] = ( boxmin[i] + boxmax[i] ) * 0.5f;
+		}
+		dist = Distance( start, center ) + Distance( center, boxmax );
+		if ( dist > length ) {
+			dist = length;
+		}
+		pad += dist * spread;
+	}
+
+	for ( i = 0; i < 3; i++ ) {
+		mins[i] = boxmin[i] - pad;
+		maxs[i] = boxmax[i] + pad;
+	}
+
+	// slab test
+	enter = 0.0f;
+	leave = length;
+	for ( i = 0; i < 3; i++ ) {
+		if ( dir[i] == 0.0f ) {
+			if ( start[i] < mins[i] || start[i] > maxs[i] ) {
+				return qfalse;
+			}
+			continue;
+		}
+		t1 = ( mins[i] - start[i] ) / dir[i];
+		t2 = ( maxs[i] - start[i] ) / dir[i];
+		if ( t1 > t2 ) {
+			float t = t1; t1 = t2; t2 = t;
+		}
+		if ( t1 > enter ) {
+			enter = t1;
+		}
+		if ( t2 < leave ) {
+			leave = t2;
+		}
+		if ( enter > leave ) {
+			return qfalse;
+		}
+	}
+
+	return qtrue;
+}
+
+
+/*
+=====================
+G_TimeShiftClientsForShot
+
+Like G_TimeShiftAllClients but only moves the clients the shot can touch.
+A client is left alone only if the shot misses both his current and his
+shifted position, so the traces that follow give the same results
+=====================
+*/
+static void G_TimeShiftClientsForShot( int ltime, gentity_t *skip, const vec3_t start, const vec3_t end, float spread ) {
+	int			i;
+	gentity_t	*ent;
+	vec3_t		dir, origin, mins, maxs, absmin, absmax;
+	float		length;
+
+	VectorSubtract( end, start, dir );
+	length = VectorNormalize( dir );
+
+	ent = &g_entities[0];
+	for ( i = 0; i < level.maxclients; i++, ent++ ) 
+	{
+		if ( ent == skip )
+			continue;
+
+		if ( !ent->r.linked )
+			continue;
+
+		if ( !ent->client || !ent->inuse || ent->client->sess.sessionTeam >= TEAM_SPECTATOR ) 
+			continue;
+
+		if ( !G_TimeShiftTarget( ent->client, ltime, origin, mins, maxs ) )
+			continue;
+
+		// traces clip against the origin based box, not the linked bounds
+		VectorAdd( ent->r.currentOrigin, ent->r.mins, absmin );
+		VectorAdd( ent->r.currentOrigin, ent->r.maxs, absmax );
+		if ( !G_ShotMayHit( start, dir, length, spread, absmin, absmax ) ) {
+			VectorAdd( origin, mins, absmin );
+			VectorAdd( origin, maxs, absmax );
+			if ( !G_ShotMayHit( start, dir, length, spread, absmin, absmax ) )
+				continue;
+		}
+
+		G_TimeShiftApply( ent, origin, mins, maxs );
+	}
+}
+
+
 /*
 ================
 G_DoTimeShiftFor
 
-Decide what time to shift everyone back to, and do it
+Decide what time to shift everyone back to, and do it for the
+clients that a shot from "start" to "end" can reach
 ================
 */
-void G_DoTimeShiftFor( gentity_t *ent ) {	
+void G_DoTimeShiftFor( gentity_t *ent, const vec3_t start, const vec3_t end, float spread ) {
 	int time;
 
 	// don't time shift for mistakes or bots
@@ -191,7 +340,11 @@ void G_DoTimeShiftFor( gentity_t *ent ) {
 		time = level.previousTime + ent->client->frameOffset;
 	}
 
-	G_TimeShiftAllClients( time, ent );
+	if ( g_unlaggedCull.integer ) {
+		G_TimeShiftClientsForShot( time, ent, start, end, spread );
+	} else {
+		G_TimeShiftAllClients( time, ent );
+	}
 }
 
 
@@ -124,6 +124,173 @@ void G_TeamCommand( team_t team, const char *cmd ) {
 }
 
 
+/*
+=========================================================================
+
+classname / targetname index
+
+Entities are chained per hash of their classname and targetname, in entity
+number order, so G_Find on those fields only looks at entities that share
+the hash.  Both fields must be changed with G_SetClassname/G_SetTargetname
+(or resynced with them after being written directly, as the spawn parser does).
+
+=========================================================================
+*/
+
+#define ENTITY_HASH_SIZE	256
+
+typedef struct {
+	int		fieldofs;
+	int		head[ENTITY_HASH_SIZE];		// lowest entity number in each chain, -1 if empty
+	int		next[MAX_GENTITIES];
+	int		chain[MAX_GENTITIES];		// chain the entity is in, -1 if not indexed
+} entityIndex_t;
+
+static entityIndex_t	classnameIndex;
+static entityIndex_t	targetnameIndex;
+
+
+static int G_HashName( const char *name ) {
+	unsigned	hash;
+	int			c;
+
+	hash = 0;
+	while ( ( c = *name++ ) != '\0' ) {
+		if ( c >= 'A' && c <= 'Z' ) {
+			c += 'a' - 'A';
+		}
+		hash = hash * 31 + c;
+	}
+
+	return hash & ( ENTITY_HASH_SIZE - 1 );
+}
+
+
+static void G_IndexReset( entityIndex_t *index, int fieldofs ) {
+	index->fieldofs = fieldofs;
+	memset( index->head, -1, sizeof( index->head ) );
+	memset( index->next, -1, sizeof( index->next ) );
+	memset( index->chain, -1, sizeof( index->chain ) );
+}
+
+
+static void G_IndexRemove( entityIndex_t *index, int num ) {
+	int		*link;
+
+	if ( index->chain[ num ] < 0 ) {
+		return;
+	}
+
+	for ( link = &index->head[ index->chain[ num ] ]; *link != -1; link = &index->next[ *link ] ) {
+		if ( *link == num ) {
+			*link = index->next[ num ];
+			break;
+		}
+	}
+
+	index->next[ num ] = -1;
+	index->chain[ num ] = -1;
+}
+
+
+static void G_IndexInsert( entityIndex_t *index, int num, const char *name ) {
+	int		*link;
+	int		h;
+
+	if ( !name ) {
+		return;
+	}
+
+	h = G_HashName( name );
+	for ( link = &index->head[ h ]; *link != -1 && *link < num; link = &index->next[ *link ] )
+		;
+
+	index->next[ num ] = *link;
+	index->chain[ num ] = h;
+	*link = num;
+}
+
+
+/*
+=============
+G_InitEntityIndex
+
+Called after g_entities was cleared
+=============
+*/
+void G_InitEntityIndex( void ) {
+	G_IndexReset( &classnameIndex, FOFS( classname ) );
+	G_IndexReset( &targetnameIndex, FOFS( targetname ) );
+}
+
+
+void G_SetClassname( gentity_t *ent, const char *classname ) {
+	int		num = ent - g_entities;
+
+	G_IndexRemove( &classnameIndex, num );
+	ent->classname = classname;
+	G_IndexInsert( &classnameIndex, num, classname );
+}
+
+
+void G_SetTargetname( gentity_t *ent, const char *targetname ) {
+	int		num = ent - g_entities;
+
+	G_IndexRemove( &targetnameIndex, num );
+	ent->targetname = targetname;
+	G_IndexInsert( &targetnameIndex, num, targetname );
+}
+
+
+/*
+=============
+G_UnindexEntity
+
+Removes the entity from the name index before it gets cleared
+=============
+*/
+void G_UnindexEntity( gentity_t *ent ) {
+	int		num = ent - g_entities;
+
+	G_IndexRemove( &classnameIndex, num );
+	G_IndexRemove( &targetnameIndex, num );
+}
+
+
+static gentity_t *G_FindIndexed( const entityIndex_t *index, gentity_t *from, const char *match ) {
+	gentity_t	*ent;
+	char		*s;
+	int			h, n;
+
+	h = G_HashName( match );
+
+	if ( from && index->chain[ from - g_entities ] == h ) {
+		// continuing an iteration, pick up right after the previous match
+		n = index->next[ from - g_entities ];
+	} else {
+		n = index->head[ h ];
+		if ( from ) {
+			while ( n != -1 && n <= from - g_entities ) {
+				n = index->next[ n ];
+			}
+		}
+	}
+
+	for ( ; n != -1; n = index->next[ n ] ) {
+		ent = &g_entities[ n ];
+		if ( !ent->inuse )
+			continue;
+		s = *(char **) ((byte *)ent + index->fieldofs);
+		if ( !s )
+			continue;
+		if ( !Q_stricmp( s, match ) )
+			return ent;
+	}
+
+	return NULL;
+}
+
+
 /*
 =============
 G_Find
@@ -141,6 +308,13 @@ gentity_t *G_Find (gentity_t *from, int fieldofs, const char *match)
 	const gentity_t *to;
 	char	*s;
 
+	if ( fieldofs == FOFS( classname ) ) {
+		return G_FindIndexed( &classnameIndex, from, match );
+	}
+	if ( fieldofs == FOFS( targetname ) ) {
+		return G_FindIndexed( &targetnameIndex, from, match );
+	}
+
 	if (!from)
 		from = g_entities;
 	else
@@ -352,13 +526,106 @@ float vectoyaw( const vec3_t vec ) {
 
 void G_InitGentity( gentity_t *e ) {
 	e->inuse = qtrue;
-	e->classname = "noclass";
+	G_SetClassname( e, "noclass" );
 	e->s.number = e - g_entities;
 	e->r.ownerNum = ENTITYNUM_NONE;
 	e->tag = TAG_NONE;
 }
 
 
+/*
+=========================================================================
+
+entity slot allocation
+
+Freed slots are queued in the order they were freed, which is also freetime
+order, so the slot that has been free the longest is always at the head and
+G_Spawn never has to scan for one.
+
+=========================================================================
+*/
+
+#define ENTITY_REUSE_DELAY	1000	// msec a slot should stay free before reuse
+
+static int		freeHead, freeTail;
+static int		freeNext[MAX_GENTITIES];
+static int		freePrev[MAX_GENTITIES];
+static qboolean	freeQueued[MAX_GENTITIES];
+static int		numFree;
+
+static struct {
+	int		spawns;			// G_Spawn calls
+	int		opened;			// new slots opened at level.num_entities
+	int		reused;			// freed slots handed out again
+	int		earlyReuses;	// reused before ENTITY_REUSE_DELAY, may morph on clients
+	int		frees;
+	int		peakInUse;		// highest number of non-client entities in use
+	int		minFree;		// lowest number of unused slots left (MAX_NORMAL included)
+} entityStats;
+
+
+static void G_QueueFree( int num ) {
+	freeNext[ num ] = -1;
+	freePrev[ num ] = freeTail;
+	if ( freeTail != -1 ) {
+		freeNext[ freeTail ] = num;
+	} else {
+		freeHead = num;
+	}
+	freeTail = num;
+	freeQueued[ num ] = qtrue;
+	numFree++;
+}
+
+
+static void G_UnqueueFree( int num ) {
+	if ( freePrev[ num ] != -1 ) {
+		freeNext[ freePrev[ num ] ] = freeNext[ num ];
+	} else {
+		freeHead = freeNext[ num ];
+	}
+	if ( freeNext[ num ] != -1 ) {
+		freePrev[ freeNext[ num ] ] = freePrev[ num ];
+	} else {
+		freeTail = freePrev[ num ];
+	}
+	freeQueued[ num ] = qfalse;
+	numFree--;
+}
+
+
+/*
+=================
+G_InitEntitySlots
+
+Called after g_entities was cleared
+=================
+*/
+void G_InitEntitySlots( void ) {
+	freeHead = freeTail = -1;
+	memset( freeQueued, 0, sizeof( freeQueued ) );
+	numFree = 0;
+
+	memset( &entityStats, 0, sizeof( entityStats ) );
+	entityStats.minFree = ENTITYNUM_MAX_NORMAL - MAX_CLIENTS;
+}
+
+
+static void G_CountEntitySlots( void ) {
+	int		inUse, unused;
+
+	inUse = level.num_entities - MAX_CLIENTS - numFree;
+	if ( inUse > entityStats.peakInUse ) {
+		entityStats.peakInUse = inUse;
+	}
+
+	unused = numFree + ENTITYNUM_MAX_NORMAL - level.num_entities;
+	if ( unused < entityStats.minFree ) {
+		entityStats.minFree = unused;
+	}
+}
+
+
 /*
 =================
 G_Spawn
@@ -375,37 +642,38 @@ angles and bad trails.
 =================
 */
 gentity_t *G_Spawn( void ) {
-	int			i, timeout;
+	int			i;
 	gentity_t	*e;
 
-	e = NULL; // shut up warning
-	// try to release oldest items first
-	for ( timeout = 1000 ; timeout >= 0 ; timeout -= 250 ) {
-		// if we go through all entities and can't find one to free,
-		// override the normal minimum times before use
-		e = &g_entities[ MAX_CLIENTS ];
-		for ( i = MAX_CLIENTS ; i < level.num_entities; i++, e++ ) {
-			if ( e->inuse ) {
-				continue;
-			}
-
-			// the first couple seconds of server time can involve a lot of
-			// freeing and allocating, so relax the replacement policy
-			if ( e->freetime > level.startTime + 2000 && level.time - e->freetime < timeout ) {
-				continue;
-			}
+	entityStats.spawns++;
 
-			// reuse this slot
+	// try to release oldest items first
+	if ( freeHead != -1 ) {
+		e = &g_entities[ freeHead ];
+
+		// the first couple seconds of server time can involve a lot of
+		// freeing and allocating, so relax the replacement policy
+		if ( e->freetime <= level.startTime + 2000 || level.time - e->freetime >= ENTITY_REUSE_DELAY ) {
+			G_UnqueueFree( freeHead );
+			entityStats.reused++;
 			G_InitGentity( e );
+			G_CountEntitySlots();
 			return e;
 		}
+	}
 
-		if ( level.num_entities < ENTITYNUM_MAX_NORMAL ) {
-			break;
+	if ( level.num_entities == ENTITYNUM_MAX_NORMAL ) {
+		// no room to grow, override the normal minimum times before use
+		if ( freeHead != -1 ) {
+			e = &g_entities[ freeHead ];
+			G_UnqueueFree( freeHead );
+			entityStats.reused++;
+			entityStats.earlyReuses++;
+			G_InitGentity( e );
+			G_CountEntitySlots();
+			return e;
 		}
-	}
 
-	if ( i == ENTITYNUM_MAX_NORMAL ) {
 		for (i = 0; i < MAX_GENTITIES; i++) {
 			G_Printf("%4i: %s\n", i, g_entities[i].classname);
 		}
@@ -413,13 +681,16 @@ gentity_t *G_Spawn( void ) {
 	}
 	
 	// open up a new slot
+	e = &g_entities[ level.num_entities ];
 	level.num_entities++;
+	entityStats.opened++;
 
 	// let the server system know that there are more entities
 	trap_LocateGameData( level.gentities, level.num_entities, sizeof( gentity_t ), 
 		&level.clients[0].ps, sizeof( level.clients[0] ) );
 
 	G_InitGentity( e );
+	G_CountEntitySlots();
 	return e;
 }
 
@@ -430,18 +701,8 @@ G_EntitiesFree
 =================
 */
 qboolean G_EntitiesFree( void ) {
-	int			i;
-	gentity_t	*e;
-
-	e = &g_entities[MAX_CLIENTS];
-	for ( i = MAX_CLIENTS; i < level.num_entities; i++, e++) {
-		if ( e->inuse ) {
-			continue;
-		}
-		// slot available
-		return qtrue;
-	}
-	return qfalse;
+	// slot available
+	return numFree > 0 ? qtrue : qfalse;
 }
 
 
@@ -453,16 +714,48 @@ Marks the entity as free
 =================
 */
 void G_FreeEntity( gentity_t *ed ) {
+	int		num;
+
 	trap_UnlinkEntity (ed);		// unlink from world
 
 	if ( ed->neverFree ) {
 		return;
 	}
 
+	G_UnindexEntity( ed );
+
 	memset (ed, 0, sizeof(*ed));
 	ed->classname = "freed";
 	ed->freetime = level.time;
 	ed->inuse = qfalse;
+
+	// client slots are never handed out by G_Spawn
+	num = ed - g_entities;
+	if ( num >= MAX_CLIENTS && num < ENTITYNUM_MAX_NORMAL ) {
+		// freed again, keep the queue in freetime order
+		if ( freeQueued[ num ] ) {
+			G_UnqueueFree( num );
+		}
+		G_QueueFree( num );
+		entityStats.frees++;
+	}
+}
+
+
+/*
+=================
+Svcmd_EntityStats_f
+
+Allocation pressure since the level started
+=================
+*/
+void Svcmd_EntityStats_f( void ) {
+	G_Printf( "entity slots: %i of %i opened, %i in use, %i free\n",
+		level.num_entities - MAX_CLIENTS, ENTITYNUM_MAX_NORMAL - MAX_CLIENTS,
+		level.num_entities - MAX_CLIENTS - numFree, numFree );
+	G_Printf( "peak in use: %i, fewest unused: %i\n", entityStats.peakInUse, entityStats.minFree );
+	G_Printf( "spawns: %i (%i new slots, %i reused, %i reused early), frees: %i\n",
+		entityStats.spawns, entityStats.opened, entityStats.reused, entityStats.earlyReuses, entityStats.frees );
 }
 
 
@@ -482,7 +775,7 @@ gentity_t *G_TempEntity( vec3_t origin, int event ) {
 	e = G_Spawn();
 	e->s.eType = ET_EVENTS + event;
 
-	e->classname = "tempEntity";
+	G_SetClassname( e, "tempEntity" );
 	e->eventTime = level.time;
 	e->freeAfterEvent = qtrue;
 
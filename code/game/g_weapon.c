@@ -187,7 +187,7 @@ static void Bullet_Fire( gentity_t *ent, float spread, int damage, int mod ) {
 	for ( i = 0; i < 10; i++ ) {
 
 		// unlagged
-		G_DoTimeShiftFor( ent );
+		G_DoTimeShiftFor( ent, muzzle_origin, end, 0.0f );
 
 		trap_Trace( &tr, muzzle_origin, NULL, NULL, end, passent, MASK_SHOT );
 
@@ -307,6 +307,8 @@ static qboolean ShotgunPellet( const vec3_t start, const vec3_t end, gentity_t *
 				if (G_InvulnerabilityEffect( traceEnt, forward, tr.endpos, impactpoint, bouncedir )) {
 					G_BounceProjectile( tr_start, impactpoint, bouncedir, tr_end );
 					VectorCopy( impactpoint, tr_start );
+					// unlagged, the bounced pellet can reach other clients
+					G_DoTimeShiftFor( ent, tr_start, tr_end, 0.0f );
 					// the player can hit him/herself with the bounced rail
 					passent = ENTITYNUM_NONE;
 				}
@@ -329,6 +331,10 @@ static qboolean ShotgunPellet( const vec3_t start, const vec3_t end, gentity_t *
 }
 
 
+// lateral pellet deviation per unit of distance, r and u below are each
+// up to DEFAULT_SHOTGUN_SPREAD * 16 at a distance of 8192 * 16
+#define SHOTGUN_CONE_SPREAD	( DEFAULT_SHOTGUN_SPREAD * 1.4143f / 8192.0f )
+
 // this should match CG_ShotgunPattern
 static void ShotgunPattern( const vec3_t origin, const vec3_t origin2, int seed, gentity_t *ent ) {
 	int			i;
@@ -344,7 +350,8 @@ static void ShotgunPattern( const vec3_t origin, const vec3_t origin2, int seed,
 	CrossProduct( forward, right, up );
 
 	// unlagged
-	G_DoTimeShiftFor( ent );
+	VectorMA( origin, ( 8192.0 * 16.0 ), forward, end );
+	G_DoTimeShiftFor( ent, origin, end, SHOTGUN_CONE_SPREAD );
 
 	// generate the "random" spread pattern
 	for ( i = 0 ; i < DEFAULT_SHOTGUN_COUNT ; i++ ) {
@@ -473,7 +480,7 @@ void weapon_railgun_fire( gentity_t *ent ) {
 	VectorMA( muzzle_origin, 8192.0, forward, end );
 
 	// unlagged
-	G_DoTimeShiftFor( ent );
+	G_DoTimeShiftFor( ent, muzzle_origin, end, 0.0f );
 
 	// trace only against the solids, so the railgun will go through people
 	unlinked = 0;
@@ -490,6 +497,8 @@ void weapon_railgun_fire( gentity_t *ent ) {
 			if ( traceEnt->client && traceEnt->client->invulnerabilityTime > level.time ) {
 				if ( G_InvulnerabilityEffect( traceEnt, forward, trace.endpos, impactpoint, bouncedir ) ) {
 					G_BounceProjectile( muzzle, impactpoint, bouncedir, end );
+					// unlagged, the bounced beam can reach other clients
+					G_DoTimeShiftFor( ent, muzzle_origin, end, 0.0f );
 					// snap the endpos to integers to save net bandwidth, but nudged towards the line
 					SnapVectorTowards( trace.endpos, muzzle );
 					// send railgun beam effect
@@ -657,7 +666,7 @@ void Weapon_LightningFire( gentity_t *ent ) {
 		VectorMA( muzzle_origin, LIGHTNING_RANGE, forward, end );
 
 		// unlagged
-		G_DoTimeShiftFor( ent );
+		G_DoTimeShiftFor( ent, muzzle_origin, end, 0.0f );
 
 		trap_Trace( &tr, muzzle_origin, NULL, NULL, end, passent, MASK_SHOT );
 
@@ -1109,7 +1118,7 @@ void G_StartKamikaze( gentity_t *ent ) {
 	SnapVector( snapped );		// save network bandwidth
 	G_SetOrigin( explosion, snapped );
 
-	explosion->classname = "kamikaze";
+	G_SetClassname( explosion, "kamikaze" );
 	explosion->s.pos.trType = TR_STATIONARY;
 
 	explosion->kamikazeTime = level.time;
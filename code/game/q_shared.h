@@ -597,6 +597,7 @@ void Parse2DMatrix (char **buf_p, int y, int x, float *m);
 void Parse3DMatrix (char **buf_p, int z, int y, int x, float *m);
 
 int QDECL Com_sprintf( char *dest, int size, const char *fmt, ... );
+int Q_vsprintf( char *buffer, const char *fmt, va_list argptr );
 
 
 // mode parm for FS_FOpenFile
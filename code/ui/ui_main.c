@@ -147,7 +147,7 @@ void _UI_Refresh( int realtime );
 qboolean _UI_IsFullscreen( void );
 void UI_VideoCheck( int time );
 static void UI_CIN_SetExtents( int handle, int x, int y, int w, int h );
-int vmMain( int command, int arg0, int arg1, int arg2, int arg3, int arg4, int arg5, int arg6, int arg7, int arg8, int arg9, int arg10, int arg11  ) {
+DLLEXPORT intptr_t vmMain( int command, int arg0, int arg1, int arg2, int arg3, int arg4, int arg5, int arg6, int arg7, int arg8, int arg9, int arg10, int arg11  ) {
   switch ( command ) {
 	  case UI_GETAPIVERSION:
 		  return UI_API_VERSION;
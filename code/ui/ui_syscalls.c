@@ -8,9 +8,9 @@
 #error "Do not use in VM build"
 #endif
 
-static int (QDECL *syscall)( int arg, ... ) = (int (QDECL *)( int, ...))-1;
+static dllSyscall_t syscall = (dllSyscall_t)-1;
 
-void dllEntry( int (QDECL *syscallptr)( int arg,... ) ) {
+DLLEXPORT void dllEntry( dllSyscall_t syscallptr ) {
 	syscall = syscallptr;
 }
 
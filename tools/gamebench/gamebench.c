@@ -0,0 +1,1462 @@
+// gamebench.c -- headless stub engine that drives a native qagame module
+//
+// Loads qagame<arch>.so, answers its syscalls with a minimal in-process
+// server (box-world collision, cvars, configstrings, an in-memory
+// filesystem) and runs GAME_RUN_FRAME at a fixed sv_fps with scripted
+// usercmd streams for every client.  Per-frame wall time and per-trap
+// call counts are reported at exit, so frame-time regressions can be
+// caught without a live server.
+
+#include <dlfcn.h>
+#include <time.h>
+
+#include "../../code/game/q_shared.h"
+#include "../../code/game/bg_public.h"
+#include "../../code/game/g_public.h"
+
+#define MAX_BENCH_CVARS		1024
+#define MAX_BENCH_FILES		64
+#define MAX_BENCH_TOKENS	4096
+#define MAX_BENCH_EXEC		16
+#define MAX_WORLD_BOXES		16
+#define MAX_TRAPS			1024
+#define MAX_CMD_ARGS		64
+
+#define BENCH_GETVALUE		700		// syscall number handed out through //trap_GetValue
+#define BENCH_MICROSECONDS	701		// trap_Microseconds_Trinity
+
+#define	DIST_EPSILON		(0.03125f)
+
+typedef struct {
+	char		*name;
+	char		*string;
+	int			flags;
+	int			modificationCount;
+} benchCvar_t;
+
+typedef struct {
+	char		name[MAX_QPATH];
+	char		*data;
+	int			length;
+	int			size;
+} benchFile_t;
+
+typedef struct {
+	benchFile_t	*file;
+	int			pos;
+	qboolean	write;
+} benchHandle_t;
+
+typedef struct {
+	vec3_t		mins, maxs;
+} benchBox_t;
+
+typedef enum {
+	SCRIPT_FIGHT,
+	SCRIPT_STRAFE,
+	SCRIPT_IDLE
+} benchScript_t;
+
+typedef struct {
+	qboolean	active;
+	char		userinfo[MAX_INFO_STRING];
+	usercmd_t	cmd;
+	int			yaw;
+	int			strafeTime;
+} benchClient_t;
+
+static struct {
+	// game module
+	intptr_t	(*vmMain)( int command, int arg0, int arg1, int arg2 );
+
+	// game data
+	byte		*gentities;
+	int			numEntities;
+	int			sizeofEntity;
+	byte		*clients;
+	int			sizeofClient;
+
+	// server state
+	benchCvar_t	cvars[MAX_BENCH_CVARS];
+	int			numCvars;
+	char		*configstrings[MAX_CONFIGSTRINGS];
+	benchClient_t benchClients[MAX_CLIENTS];
+
+	// in-memory filesystem
+	benchFile_t	files[MAX_BENCH_FILES];
+	int			numFiles;
+	benchHandle_t handles[MAX_BENCH_FILES];
+
+	// map
+	benchBox_t	world[MAX_WORLD_BOXES];
+	int			numWorld;
+	char		*tokens[MAX_BENCH_TOKENS];
+	int			numTokens;
+	int			nextToken;
+
+	// console command line
+	char		cmdText[MAX_STRING_CHARS];
+	char		cmdBuffer[MAX_STRING_CHARS];
+	char		*argv[MAX_CMD_ARGS];
+	int			argc;
+
+	// statistics
+	unsigned	rng;
+	int			levelTime;
+	qboolean	verbose;
+	int			ping;			// usercmd serverTime lags behind by this much
+	long long	startTime;
+	long long	trapCounts[MAX_TRAPS];
+	long long	serverCommandBytes;
+} sv;
+
+static const char *trapNames[] = {
+	"G_PRINT", "G_ERROR", "G_MILLISECONDS", "G_CVAR_REGISTER", "G_CVAR_UPDATE",
+	"G_CVAR_SET", "G_CVAR_VARIABLE_INTEGER_VALUE", "G_CVAR_VARIABLE_STRING_BUFFER",
+	"G_ARGC", "G_ARGV", "G_FS_FOPEN_FILE", "G_FS_READ", "G_FS_WRITE",
+	"G_FS_FCLOSE_FILE", "G_SEND_CONSOLE_COMMAND", "G_LOCATE_GAME_DATA",
+	"G_DROP_CLIENT", "G_SEND_SERVER_COMMAND", "G_SET_CONFIGSTRING",
+	"G_GET_CONFIGSTRING", "G_GET_USERINFO", "G_SET_USERINFO", "G_GET_SERVERINFO",
+	"G_SET_BRUSH_MODEL", "G_TRACE", "G_POINT_CONTENTS", "G_IN_PVS",
+	"G_IN_PVS_IGNORE_PORTALS", "G_ADJUST_AREA_PORTAL_STATE", "G_AREAS_CONNECTED",
+	"G_LINKENTITY", "G_UNLINKENTITY", "G_ENTITIES_IN_BOX", "G_ENTITY_CONTACT",
+	"G_BOT_ALLOCATE_CLIENT", "G_BOT_FREE_CLIENT", "G_GET_USERCMD",
+	"G_GET_ENTITY_TOKEN", "G_FS_GETFILELIST", "G_DEBUG_POLYGON_CREATE",
+	"G_DEBUG_POLYGON_DELETE", "G_REAL_TIME", "G_SNAPVECTOR", "G_TRACECAPSULE",
+	"G_ENTITY_CONTACTCAPSULE", "G_FS_SEEK"
+};
+
+
+/*
+==============================================================
+
+UTILITIES
+
+==============================================================
+*/
+
+static void Bench_Error( const char *fmt, ... ) {
+	va_list		argptr;
+
+	va_start( argptr, fmt );
+	fprintf( stderr, "gamebench: " );
+	vfprintf( stderr, fmt, argptr );
+	va_end( argptr );
+	exit( 1 );
+}
+
+
+static long long Bench_Microseconds( void ) {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+
+static unsigned Bench_Rand( void ) {
+	sv.rng = sv.rng * 1103515245 + 12345;
+	return ( sv.rng >> 16 ) & 0x7fff;
+}
+
+
+static char *Bench_CopyString( const char *s ) {
+	char *out;
+
+	out = malloc( strlen( s ) + 1 );
+	strcpy( out, s );
+	return out;
+}
+
+
+static void Bench_Strncpyz( char *dest, const char *src, int size ) {
+	if ( size < 1 ) {
+		return;
+	}
+	snprintf( dest, size, "%s", src );
+}
+
+
+static float Bench_RadiusFromBounds( const vec3_t mins, const vec3_t maxs ) {
+	vec3_t corner;
+	int i;
+
+	for ( i = 0; i < 3; i++ ) {
+		corner[i] = fabs( mins[i] ) > fabs( maxs[i] ) ? fabs( mins[i] ) : fabs( maxs[i] );
+	}
+	return VectorLength( corner );
+}
+
+
+static void Bench_VectorToAngles( const vec3_t v, vec3_t angles ) {
+	angles[YAW] = atan2( v[1], v[0] ) * ( 180.0 / M_PI );
+	angles[PITCH] = -atan2( v[2], sqrt( v[0] * v[0] + v[1] * v[1] ) ) * ( 180.0 / M_PI );
+	angles[ROLL] = 0;
+}
+
+
+static sharedEntity_t *Bench_GentityNum( int num ) {
+	return (sharedEntity_t *)( sv.gentities + sv.sizeofEntity * num );
+}
+
+
+static playerState_t *Bench_GameClientNum( int num ) {
+	return (playerState_t *)( sv.clients + sv.sizeofClient * num );
+}
+
+
+/*
+==============================================================
+
+CVARS
+
+==============================================================
+*/
+
+static benchCvar_t *Bench_FindCvar( const char *name ) {
+	int i;
+
+	for ( i = 0; i < sv.numCvars; i++ ) {
+		if ( !strcasecmp( sv.cvars[i].name, name ) ) {
+			return &sv.cvars[i];
+		}
+	}
+	return NULL;
+}
+
+
+static benchCvar_t *Bench_CvarGet( const char *name, const char *value, int flags ) {
+	benchCvar_t *cv;
+
+	cv = Bench_FindCvar( name );
+	if ( cv ) {
+		cv->flags |= flags;
+		return cv;
+	}
+	if ( sv.numCvars == MAX_BENCH_CVARS ) {
+		Bench_Error( "too many cvars\n" );
+	}
+	cv = &sv.cvars[sv.numCvars++];
+	cv->name = Bench_CopyString( name );
+	cv->string = Bench_CopyString( value );
+	cv->flags = flags;
+	cv->modificationCount = 1;
+	return cv;
+}
+
+
+static void Bench_CvarSet( const char *name, const char *value ) {
+	benchCvar_t *cv;
+
+	cv = Bench_FindCvar( name );
+	if ( !cv ) {
+		Bench_CvarGet( name, value, CVAR_USER_CREATED );
+		return;
+	}
+	if ( !strcmp( cv->string, value ) ) {
+		return;
+	}
+	free( cv->string );
+	cv->string = Bench_CopyString( value );
+	cv->modificationCount++;
+}
+
+
+static const char *Bench_CvarString( const char *name ) {
+	benchCvar_t *cv;
+
+	cv = Bench_FindCvar( name );
+	return cv ? cv->string : "";
+}
+
+
+static void Bench_CvarUpdate( vmCvar_t *vmCvar ) {
+	benchCvar_t *cv;
+
+	if ( (unsigned)vmCvar->handle >= sv.numCvars ) {
+		return;
+	}
+	cv = &sv.cvars[vmCvar->handle];
+	if ( cv->modificationCount == vmCvar->modificationCount ) {
+		return;
+	}
+	vmCvar->modificationCount = cv->modificationCount;
+	Bench_Strncpyz( vmCvar->string, cv->string, sizeof( vmCvar->string ) );
+	vmCvar->value = atof( cv->string );
+	vmCvar->integer = atoi( cv->string );
+}
+
+
+static void Bench_CvarRegister( vmCvar_t *vmCvar, const char *name, const char *value, int flags ) {
+	benchCvar_t *cv;
+
+	cv = Bench_CvarGet( name, value, flags );
+	if ( !vmCvar ) {
+		return;
+	}
+	vmCvar->handle = cv - sv.cvars;
+	vmCvar->modificationCount = -1;
+	Bench_CvarUpdate( vmCvar );
+}
+
+
+static void Bench_Serverinfo( char *buffer, int size ) {
+	char	info[BIG_INFO_STRING];
+	int		i;
+
+	info[0] = '\0';
+	for ( i = 0; i < sv.numCvars; i++ ) {
+		if ( sv.cvars[i].flags & CVAR_SERVERINFO ) {
+			int len = strlen( info );
+			snprintf( info + len, sizeof( info ) - len, "\\%s\\%s", sv.cvars[i].name, sv.cvars[i].string );
+		}
+	}
+	Bench_Strncpyz( buffer, info, size );
+}
+
+
+/*
+==============================================================
+
+IN-MEMORY FILESYSTEM
+
+==============================================================
+*/
+
+static benchFile_t *Bench_FindFile( const char *qpath, qboolean create ) {
+	benchFile_t *f;
+	int i;
+
+	for ( i = 0; i < sv.numFiles; i++ ) {
+		if ( !strcasecmp( sv.files[i].name, qpath ) ) {
+			return &sv.files[i];
+		}
+	}
+	if ( !create ) {
+		return NULL;
+	}
+	if ( sv.numFiles == MAX_BENCH_FILES ) {
+		Bench_Error( "too many files\n" );
+	}
+	f = &sv.files[sv.numFiles++];
+	Bench_Strncpyz( f->name, qpath, sizeof( f->name ) );
+	return f;
+}
+
+
+static void Bench_AddHostFile( const char *qpath, const char *hostpath ) {
+	benchFile_t *f;
+	FILE *fp;
+	long len;
+
+	fp = fopen( hostpath, "rb" );
+	if ( !fp ) {
+		Bench_Error( "couldn't open %s\n", hostpath );
+	}
+	fseek( fp, 0, SEEK_END );
+	len = ftell( fp );
+	fseek( fp, 0, SEEK_SET );
+
+	f = Bench_FindFile( qpath, qtrue );
+	free( f->data );
+	f->data = malloc( len + 1 );
+	f->length = fread( f->data, 1, len, fp );
+	f->size = len + 1;
+	fclose( fp );
+}
+
+
+static int Bench_FOpenFile( const char *qpath, fileHandle_t *h, fsMode_t mode ) {
+	benchFile_t *f;
+	int i;
+
+	*h = 0;
+	f = Bench_FindFile( qpath, mode != FS_READ );
+	if ( !f ) {
+		return -1;
+	}
+	for ( i = 1; i < MAX_BENCH_FILES; i++ ) {
+		if ( !sv.handles[i].file ) {
+			break;
+		}
+	}
+	if ( i == MAX_BENCH_FILES ) {
+		return -1;
+	}
+	if ( mode == FS_WRITE ) {
+		f->length = 0;
+	}
+	sv.handles[i].file = f;
+	sv.handles[i].pos = ( mode == FS_READ ) ? 0 : f->length;
+	sv.handles[i].write = ( mode != FS_READ );
+	*h = i;
+	return ( mode == FS_READ ) ? f->length : 0;
+}
+
+
+static benchHandle_t *Bench_Handle( fileHandle_t h ) {
+	if ( h <= 0 || h >= MAX_BENCH_FILES || !sv.handles[h].file ) {
+		return NULL;
+	}
+	return &sv.handles[h];
+}
+
+
+static int Bench_FRead( void *buffer, int len, fileHandle_t h ) {
+	benchHandle_t *fh;
+
+	fh = Bench_Handle( h );
+	if ( !fh ) {
+		return 0;
+	}
+	if ( len > fh->file->length - fh->pos ) {
+		len = fh->file->length - fh->pos;
+	}
+	memcpy( buffer, fh->file->data + fh->pos, len );
+	fh->pos += len;
+	return len;
+}
+
+
+static int Bench_FWrite( const void *buffer, int len, fileHandle_t h ) {
+	benchHandle_t *fh;
+	benchFile_t *f;
+
+	fh = Bench_Handle( h );
+	if ( !fh || !fh->write ) {
+		return 0;
+	}
+	f = fh->file;
+	if ( fh->pos + len > f->size ) {
+		f->size = ( fh->pos + len ) * 2;
+		f->data = realloc( f->data, f->size );
+	}
+	memcpy( f->data + fh->pos, buffer, len );
+	fh->pos += len;
+	if ( fh->pos > f->length ) {
+		f->length = fh->pos;
+	}
+	return len;
+}
+
+
+/*
+==============================================================
+
+BOX WORLD
+
+The world is a closed room built from axial boxes, and every linked
+entity is clipped as its absolute bounding box.  That is enough to keep
+players on the floor, drop items and stop hitscan and missiles.
+
+==============================================================
+*/
+
+static void Bench_AddWorldBox( float x0, float y0, float z0, float x1, float y1, float z1 ) {
+	benchBox_t *b;
+
+	if ( sv.numWorld == MAX_WORLD_BOXES ) {
+		return;
+	}
+	b = &sv.world[sv.numWorld++];
+	VectorSet( b->mins, x0, y0, z0 );
+	VectorSet( b->maxs, x1, y1, z1 );
+}
+
+
+static void Bench_BuildWorld( float size, float height ) {
+	float h = size * 0.5f;
+
+	Bench_AddWorldBox( -h - 64, -h - 64, -64, h + 64, h + 64, 0 );				// floor
+	Bench_AddWorldBox( -h - 64, -h - 64, height, h + 64, h + 64, height + 64 );	// ceiling
+	Bench_AddWorldBox( -h - 64, -h - 64, 0, -h, h + 64, height );				// walls
+	Bench_AddWorldBox( h, -h - 64, 0, h + 64, h + 64, height );
+	Bench_AddWorldBox( -h, -h - 64, 0, h, -h, height );
+	Bench_AddWorldBox( -h, h, 0, h, h + 64, height );
+	Bench_AddWorldBox( -h * 0.5f - 64, -h * 0.5f - 64, 0, -h * 0.5f + 64, -h * 0.5f + 64, height );	// pillars
+	Bench_AddWorldBox( h * 0.5f - 64, -h * 0.5f - 64, 0, h * 0.5f + 64, -h * 0.5f + 64, height );
+	Bench_AddWorldBox( -h * 0.5f - 64, h * 0.5f - 64, 0, -h * 0.5f + 64, h * 0.5f + 64, height );
+	Bench_AddWorldBox( h * 0.5f - 64, h * 0.5f - 64, 0, h * 0.5f + 64, h * 0.5f + 64, height );
+}
+
+
+/*
+==================
+Bench_ClipBox
+
+Sweeps the box mins/maxs from start to end against the solid box
+bmins/bmaxs and updates trace if the hit is closer than the current one.
+==================
+*/
+static qboolean Bench_ClipBox( trace_t *trace, const vec3_t start, const vec3_t end, const vec3_t mins, const vec3_t maxs,
+							   const vec3_t bmins, const vec3_t bmaxs ) {
+	float	enter, leave, len;
+	int		axis, i;
+	vec3_t	emins, emaxs, dir;
+
+	enter = -1.0f;
+	leave = 1.0f;
+	axis = -1;
+
+	VectorSubtract( bmins, maxs, emins );
+	VectorSubtract( bmaxs, mins, emaxs );
+	VectorSubtract( end, start, dir );
+
+	for ( i = 0; i < 3; i++ ) {
+		float t0, t1;
+
+		if ( dir[i] == 0.0f ) {
+			if ( start[i] <= emins[i] || start[i] >= emaxs[i] ) {
+				return qfalse;
+			}
+			continue;
+		}
+		t0 = ( emins[i] - start[i] ) / dir[i];
+		t1 = ( emaxs[i] - start[i] ) / dir[i];
+		if ( t0 > t1 ) {
+			float t = t0; t0 = t1; t1 = t;
+		}
+		if ( t0 > enter ) {
+			enter = t0;
+			axis = i;
+		}
+		if ( t1 < leave ) {
+			leave = t1;
+		}
+		if ( enter >= leave ) {
+			return qfalse;
+		}
+	}
+
+	if ( leave <= 0.0f || enter >= 1.0f ) {
+		return qfalse;
+	}
+
+	if ( axis == -1 || enter < 0.0f ) {
+		// started inside the box
+		trace->startsolid = qtrue;
+		if ( leave >= 1.0f ) {
+			trace->allsolid = qtrue;
+		}
+		trace->fraction = 0.0f;
+		VectorClear( trace->plane.normal );
+		return qtrue;
+	}
+
+	if ( enter >= trace->fraction ) {
+		return qfalse;
+	}
+
+	len = VectorLength( dir );
+	enter -= DIST_EPSILON / len;
+	if ( enter < 0.0f ) {
+		enter = 0.0f;
+	}
+	trace->fraction = enter;
+	VectorClear( trace->plane.normal );
+	trace->plane.normal[axis] = dir[axis] > 0.0f ? -1.0f : 1.0f;
+	trace->plane.type = axis;
+	trace->plane.dist = trace->plane.normal[axis] > 0.0f ? bmaxs[axis] : -bmins[axis];
+	return qtrue;
+}
+
+
+static qboolean Bench_BoxesOverlap( const vec3_t amins, const vec3_t amaxs, const vec3_t bmins, const vec3_t bmaxs ) {
+	return amins[0] <= bmaxs[0] && amaxs[0] >= bmins[0]
+		&& amins[1] <= bmaxs[1] && amaxs[1] >= bmins[1]
+		&& amins[2] <= bmaxs[2] && amaxs[2] >= bmins[2];
+}
+
+
+static void Bench_Trace( trace_t *trace, const vec3_t start, const vec3_t mins, const vec3_t maxs, const vec3_t end,
+						 int passEntityNum, int contentmask ) {
+	static const vec3_t	zero = { 0, 0, 0 };
+	const sharedEntity_t *pass;
+	vec3_t	tmins, tmaxs, emins, emaxs;
+	int		passOwner;
+	int		i;
+
+	if ( !mins ) {
+		mins = zero;
+	}
+	if ( !maxs ) {
+		maxs = zero;
+	}
+
+	memset( trace, 0, sizeof( *trace ) );
+	trace->fraction = 1.0f;
+	trace->entityNum = ENTITYNUM_NONE;
+
+	if ( contentmask & CONTENTS_SOLID ) {
+		for ( i = 0; i < sv.numWorld; i++ ) {
+			if ( Bench_ClipBox( trace, start, end, mins, maxs, sv.world[i].mins, sv.world[i].maxs ) ) {
+				trace->entityNum = ENTITYNUM_WORLD;
+				trace->contents = CONTENTS_SOLID;
+			}
+		}
+	}
+
+	passOwner = ENTITYNUM_NONE;
+	pass = NULL;
+	if ( passEntityNum != ENTITYNUM_NONE && passEntityNum < sv.numEntities ) {
+		pass = Bench_GentityNum( passEntityNum );
+		passOwner = pass->r.ownerNum;
+	}
+
+	// like SV_ClipMoveToEntities: the linked absolute bounds only select
+	// candidates, the clip itself uses the entity's current origin
+	for ( i = 0; i < 3; i++ ) {
+		tmins[i] = ( start[i] < end[i] ? start[i] : end[i] ) + mins[i] - 1;
+		tmaxs[i] = ( start[i] > end[i] ? start[i] : end[i] ) + maxs[i] + 1;
+	}
+
+	for ( i = 0; i < sv.numEntities && !trace->allsolid; i++ ) {
+		const sharedEntity_t *ent = Bench_GentityNum( i );
+
+		if ( !ent->r.linked || !( ent->r.contents & contentmask ) ) {
+			continue;
+		}
+		if ( i == passEntityNum ) {
+			continue;
+		}
+		if ( pass && ( ent->r.ownerNum == passEntityNum || i == passOwner ) ) {
+			continue;
+		}
+		if ( !Bench_BoxesOverlap( tmins, tmaxs, ent->r.absmin, ent->r.absmax ) ) {
+			continue;
+		}
+		if ( ent->r.bmodel && ( ent->r.currentAngles[0] || ent->r.currentAngles[1] || ent->r.currentAngles[2] ) ) {
+			VectorCopy( ent->r.absmin, emins );
+			VectorCopy( ent->r.absmax, emaxs );
+		} else {
+			VectorAdd( ent->r.currentOrigin, ent->r.mins, emins );
+			VectorAdd( ent->r.currentOrigin, ent->r.maxs, emaxs );
+		}
+		if ( Bench_ClipBox( trace, start, end, mins, maxs, emins, emaxs ) ) {
+			trace->entityNum = i;
+			trace->contents = ent->r.contents;
+		}
+	}
+
+	for ( i = 0; i < 3; i++ ) {
+		trace->endpos[i] = start[i] + trace->fraction * ( end[i] - start[i] );
+	}
+}
+
+
+static int Bench_PointContents( const vec3_t p, int passEntityNum ) {
+	int contents, i;
+
+	contents = 0;
+	for ( i = 0; i < sv.numWorld; i++ ) {
+		if ( Bench_BoxesOverlap( p, p, sv.world[i].mins, sv.world[i].maxs ) ) {
+			contents |= CONTENTS_SOLID;
+		}
+	}
+	for ( i = 0; i < sv.numEntities; i++ ) {
+		const sharedEntity_t *ent = Bench_GentityNum( i );
+
+		if ( i == passEntityNum || !ent->r.linked ) {
+			continue;
+		}
+		if ( Bench_BoxesOverlap( p, p, ent->r.absmin, ent->r.absmax ) ) {
+			contents |= ent->r.contents;
+		}
+	}
+	return contents;
+}
+
+
+static void Bench_LinkEntity( sharedEntity_t *ent ) {
+	if ( ent->r.bmodel && ( ent->r.currentAngles[0] || ent->r.currentAngles[1] || ent->r.currentAngles[2] ) ) {
+		float radius = Bench_RadiusFromBounds( ent->r.mins, ent->r.maxs );
+		int i;
+
+		for ( i = 0; i < 3; i++ ) {
+			ent->r.absmin[i] = ent->r.currentOrigin[i] - radius;
+			ent->r.absmax[i] = ent->r.currentOrigin[i] + radius;
+		}
+	} else {
+		VectorAdd( ent->r.currentOrigin, ent->r.mins, ent->r.absmin );
+		VectorAdd( ent->r.currentOrigin, ent->r.maxs, ent->r.absmax );
+	}
+
+	// same one unit expansion the server applies for touch tests
+	ent->r.absmin[0] -= 1;
+	ent->r.absmin[1] -= 1;
+	ent->r.absmin[2] -= 1;
+	ent->r.absmax[0] += 1;
+	ent->r.absmax[1] += 1;
+	ent->r.absmax[2] += 1;
+
+	ent->r.linkcount++;
+	ent->r.linked = qtrue;
+}
+
+
+static int Bench_EntitiesInBox( const vec3_t mins, const vec3_t maxs, int *list, int maxcount ) {
+	int count, i;
+
+	count = 0;
+	for ( i = 0; i < sv.numEntities && count < maxcount; i++ ) {
+		const sharedEntity_t *ent = Bench_GentityNum( i );
+
+		if ( ent->r.linked && Bench_BoxesOverlap( mins, maxs, ent->r.absmin, ent->r.absmax ) ) {
+			list[count++] = i;
+		}
+	}
+	return count;
+}
+
+
+/*
+==============================================================
+
+MAP
+
+==============================================================
+*/
+
+static void Bench_AddToken( const char *s ) {
+	if ( sv.numTokens == MAX_BENCH_TOKENS ) {
+		Bench_Error( "entity string too long\n" );
+	}
+	sv.tokens[sv.numTokens++] = Bench_CopyString( s );
+}
+
+
+static void Bench_AddEntity( const char *classname, const vec3_t origin, const char *extraKey, const char *extraValue ) {
+	char buf[64];
+
+	Bench_AddToken( "{" );
+	Bench_AddToken( "classname" );
+	Bench_AddToken( classname );
+	if ( origin ) {
+		snprintf( buf, sizeof( buf ), "%i %i %i", (int)origin[0], (int)origin[1], (int)origin[2] );
+		Bench_AddToken( "origin" );
+		Bench_AddToken( buf );
+	}
+	if ( extraKey ) {
+		Bench_AddToken( extraKey );
+		Bench_AddToken( extraValue );
+	}
+	Bench_AddToken( "}" );
+}
+
+
+/*
+==================
+Bench_BuildMap
+
+Generates a worldspawn followed by numEntities spawn points, items and
+locations scattered over the room.
+==================
+*/
+static void Bench_BuildMap( int numEntities, float size ) {
+	static const char *items[] = {
+		"weapon_rocketlauncher", "weapon_railgun", "weapon_lightning", "weapon_shotgun",
+		"weapon_plasmagun", "weapon_grenadelauncher", "ammo_rockets", "ammo_slugs",
+		"ammo_lightning", "ammo_shells", "ammo_cells", "ammo_grenades", "ammo_bullets",
+		"item_health", "item_health_large", "item_health_small", "item_armor_shard",
+		"item_armor_combat", "item_armor_body", "item_quad", "item_haste", "item_regen"
+	};
+	char	buf[64];
+	vec3_t	origin;
+	int		numSpawns, i, j;
+	float	angle, radius;
+
+	Bench_AddEntity( "worldspawn", NULL, "message", "gamebench box world" );
+
+	numSpawns = numEntities / 4;
+	if ( numSpawns < 1 ) {
+		numSpawns = 1;
+	}
+	for ( i = 0; i < numEntities; i++ ) {
+		angle = ( Bench_Rand() % 360 ) * ( M_PI / 180.0 );
+		radius = size * 0.1f + ( Bench_Rand() % 1000 ) * 0.001f * size * 0.3f;
+		origin[0] = cos( angle ) * radius;
+		origin[1] = sin( angle ) * radius;
+		for ( j = 0; j < sv.numWorld; j++ ) {
+			// keep clear of the pillars
+			if ( fabs( origin[0] - ( sv.world[j].mins[0] + sv.world[j].maxs[0] ) * 0.5f ) < 128
+				&& fabs( origin[1] - ( sv.world[j].mins[1] + sv.world[j].maxs[1] ) * 0.5f ) < 128 ) {
+				origin[0] *= 0.5f;
+				origin[1] *= 0.5f;
+			}
+		}
+		if ( i < numSpawns ) {
+			origin[2] = 40;
+			snprintf( buf, sizeof( buf ), "%i", (int)( angle * 180.0 / M_PI + 180 ) % 360 );
+			Bench_AddEntity( "info_player_deathmatch", origin, "angle", buf );
+		} else if ( i % 8 == 7 ) {
+			origin[2] = 64;
+			snprintf( buf, sizeof( buf ), "location %i", i );
+			Bench_AddEntity( "target_location", origin, "message", buf );
+		} else {
+			origin[2] = 16;
+			Bench_AddEntity( items[i % ARRAY_LEN( items )], origin, NULL, NULL );
+		}
+	}
+}
+
+
+static qboolean Bench_GetEntityToken( char *buffer, int size ) {
+	if ( sv.nextToken >= sv.numTokens ) {
+		buffer[0] = '\0';
+		return qfalse;
+	}
+	Bench_Strncpyz( buffer, sv.tokens[sv.nextToken++], size );
+	return qtrue;
+}
+
+
+/*
+==============================================================
+
+SCRIPTED CLIENTS
+
+==============================================================
+*/
+
+static void Bench_ConnectClient( int clientNum, qboolean firstTime ) {
+	benchClient_t *bc;
+	const char *reason;
+
+	bc = &sv.benchClients[clientNum];
+	snprintf( bc->userinfo, sizeof( bc->userinfo ),
+		"\\name\\bench%02i\\model\\sarge\\headmodel\\sarge\\handicap\\100\\color1\\4\\rate\\25000"
+		"\\snaps\\40\\ip\\10.0.%i.%i:27960\\cg_predictItems\\1", clientNum, clientNum / 250, clientNum % 250 + 1 );
+
+	reason = (const char *)sv.vmMain( GAME_CLIENT_CONNECT, clientNum, firstTime, qfalse );
+	if ( reason ) {
+		Bench_Error( "client %i refused: %s\n", clientNum, reason );
+	}
+	if ( firstTime ) {
+		bc->active = qtrue;
+		bc->yaw = Bench_Rand() % 65536;
+	}
+	sv.vmMain( GAME_CLIENT_BEGIN, clientNum, 0, 0 );
+}
+
+
+/*
+==================
+Bench_BuildUsercmd
+
+Fills in the next usercmd for a client.  The fight script aims at the
+nearest other player and fires, which keeps the hitscan, missile and
+damage paths busy; strafe only moves; idle sends empty commands.
+==================
+*/
+static void Bench_BuildUsercmd( int clientNum, int serverTime, benchScript_t script, int numClients ) {
+	static const int weapons[] = { WP_MACHINEGUN, WP_SHOTGUN, WP_ROCKET_LAUNCHER, WP_LIGHTNING, WP_RAILGUN, WP_PLASMAGUN };
+	benchClient_t *bc;
+	usercmd_t *cmd;
+	playerState_t *ps;
+	int i, best;
+	float bestDist;
+
+	bc = &sv.benchClients[clientNum];
+	cmd = &bc->cmd;
+	ps = Bench_GameClientNum( clientNum );
+
+	memset( cmd, 0, sizeof( *cmd ) );
+	cmd->serverTime = serverTime - sv.ping;
+	cmd->weapon = ps->weapon;
+
+	if ( script == SCRIPT_IDLE ) {
+		return;
+	}
+
+	if ( serverTime >= bc->strafeTime ) {
+		bc->strafeTime = serverTime + 300 + Bench_Rand() % 1200;
+		bc->yaw += ( Bench_Rand() % 16384 ) - 8192;
+		cmd->upmove = ( Bench_Rand() % 4 == 0 ) ? 127 : 0;
+	}
+	cmd->forwardmove = 127;
+	cmd->rightmove = ( bc->strafeTime / 100 ) & 1 ? 127 : -127;
+
+	if ( script == SCRIPT_FIGHT ) {
+		best = -1;
+		bestDist = 0;
+		for ( i = 0; i < numClients; i++ ) {
+			playerState_t *other = Bench_GameClientNum( i );
+			float d;
+
+			if ( i == clientNum || other->stats[STAT_HEALTH] <= 0 ) {
+				continue;
+			}
+			d = DistanceSquared( ps->origin, other->origin );
+			if ( best == -1 || d < bestDist ) {
+				best = i;
+				bestDist = d;
+			}
+		}
+		if ( best != -1 ) {
+			vec3_t dir, angles;
+
+			VectorSubtract( Bench_GameClientNum( best )->origin, ps->origin, dir );
+			Bench_VectorToAngles( dir, angles );
+			cmd->angles[YAW] = ANGLE2SHORT( angles[YAW] ) - ps->delta_angles[YAW];
+			cmd->angles[PITCH] = ANGLE2SHORT( angles[PITCH] ) - ps->delta_angles[PITCH];
+			// fire in bursts, the button has to be released once after spawning
+			if ( ( serverTime + clientNum * 137 ) % 2000 < 1500 ) {
+				cmd->buttons |= BUTTON_ATTACK;
+			}
+		}
+		if ( ( serverTime / 2000 + clientNum ) % 3 == 0 ) {
+			cmd->weapon = weapons[( serverTime / 2000 + clientNum ) % ARRAY_LEN( weapons )];
+		}
+	}
+
+	if ( script != SCRIPT_FIGHT || !( cmd->buttons & BUTTON_ATTACK ) ) {
+		cmd->angles[YAW] = bc->yaw - ps->delta_angles[YAW];
+	}
+
+	// dead players respawn by pressing attack
+	if ( ps->stats[STAT_HEALTH] <= 0 && ( serverTime / 100 ) & 1 ) {
+		cmd->buttons |= BUTTON_ATTACK;
+	}
+}
+
+
+/*
+==============================================================
+
+SYSCALLS
+
+==============================================================
+*/
+
+static void Bench_TokenizeString( const char *text ) {
+	char *s;
+
+	Bench_Strncpyz( sv.cmdBuffer, text, sizeof( sv.cmdBuffer ) );
+	sv.argc = 0;
+	s = sv.cmdBuffer;
+	while ( *s && sv.argc < MAX_CMD_ARGS ) {
+		while ( *s == ' ' ) {
+			*s++ = '\0';
+		}
+		if ( !*s ) {
+			break;
+		}
+		sv.argv[sv.argc++] = s;
+		while ( *s && *s != ' ' ) {
+			s++;
+		}
+	}
+}
+
+
+static void Bench_AppendCommand( const char *text ) {
+	int len = strlen( sv.cmdText );
+
+	Bench_Strncpyz( sv.cmdText + len, text, sizeof( sv.cmdText ) - len );
+}
+
+
+/*
+==================
+Bench_RestartGame
+
+Emulates map_restart (restart) and map (full reload) the way the server
+does it: the game is shut down and initialized again and every scripted
+client reconnects.
+==================
+*/
+static void Bench_RestartGame( qboolean restart ) {
+	int c;
+
+	sv.vmMain( GAME_SHUTDOWN, restart, 0, 0 );
+	sv.nextToken = 0;
+	sv.vmMain( GAME_INIT, sv.levelTime, sv.rng, restart );
+	for ( c = 0; c < MAX_CLIENTS; c++ ) {
+		if ( sv.benchClients[c].active ) {
+			Bench_ConnectClient( c, qfalse );
+		}
+	}
+}
+
+
+/*
+==================
+Bench_ExecuteCommands
+
+Runs the commands the game queued with trap_SendConsoleCommand.  Only
+the ones that change game state are emulated, everything else is
+ignored.
+==================
+*/
+static void Bench_ExecuteCommands( void ) {
+	char	text[MAX_STRING_CHARS];
+	char	*line, *next;
+
+	Bench_Strncpyz( text, sv.cmdText, sizeof( text ) );
+	sv.cmdText[0] = '\0';
+
+	for ( line = text; line && *line; line = next ) {
+		next = strchr( line, '\n' );
+		if ( next ) {
+			*next++ = '\0';
+		}
+		Bench_TokenizeString( line );
+		if ( !sv.argc ) {
+			continue;
+		}
+		if ( sv.verbose ) {
+			printf( "gamebench: %s\n", line );
+		}
+		if ( !strcasecmp( sv.argv[0], "map_restart" ) ) {
+			Bench_RestartGame( qtrue );
+		} else if ( !strcasecmp( sv.argv[0], "map" ) || !strcasecmp( sv.argv[0], "vstr" ) ) {
+			Bench_RestartGame( qfalse );
+		} else if ( ( !strcasecmp( sv.argv[0], "set" ) || !strcasecmp( sv.argv[0], "seta" ) ) && sv.argc >= 3 ) {
+			Bench_CvarSet( sv.argv[1], sv.argv[2] );
+		}
+	}
+}
+
+
+static intptr_t QDECL Bench_Syscall( intptr_t cmd, ... ) {
+	intptr_t	args[12];
+	va_list		ap;
+	int			i;
+
+	va_start( ap, cmd );
+	for ( i = 0; i < ARRAY_LEN( args ); i++ ) {
+		args[i] = va_arg( ap, intptr_t );
+	}
+	va_end( ap );
+
+	if ( (unsigned)cmd < MAX_TRAPS ) {
+		sv.trapCounts[cmd]++;
+	}
+
+	switch ( cmd ) {
+	case G_PRINT:
+		if ( sv.verbose ) {
+			fputs( (const char *)args[0], stdout );
+		}
+		return 0;
+	case G_ERROR:
+		Bench_Error( "game error: %s\n", (const char *)args[0] );
+		return 0;
+	case G_MILLISECONDS:
+		return (int)( ( Bench_Microseconds() - sv.startTime ) / 1000 );
+	case G_CVAR_REGISTER:
+		Bench_CvarRegister( (vmCvar_t *)args[0], (const char *)args[1], (const char *)args[2], (int)args[3] );
+		return 0;
+	case G_CVAR_UPDATE:
+		Bench_CvarUpdate( (vmCvar_t *)args[0] );
+		return 0;
+	case G_CVAR_SET:
+		Bench_CvarSet( (const char *)args[0], (const char *)args[1] );
+		return 0;
+	case G_CVAR_VARIABLE_INTEGER_VALUE:
+		return atoi( Bench_CvarString( (const char *)args[0] ) );
+	case G_CVAR_VARIABLE_STRING_BUFFER:
+		Bench_Strncpyz( (char *)args[1], Bench_CvarString( (const char *)args[0] ), (int)args[2] );
+		return 0;
+	case G_ARGC:
+		return sv.argc;
+	case G_ARGV:
+		Bench_Strncpyz( (char *)args[1], (int)args[0] < sv.argc ? sv.argv[(int)args[0]] : "", (int)args[2] );
+		return 0;
+	case G_FS_FOPEN_FILE:
+		return Bench_FOpenFile( (const char *)args[0], (fileHandle_t *)args[1], (fsMode_t)args[2] );
+	case G_FS_READ:
+		return Bench_FRead( (void *)args[0], (int)args[1], (fileHandle_t)args[2] );
+	case G_FS_WRITE:
+		return Bench_FWrite( (const void *)args[0], (int)args[1], (fileHandle_t)args[2] );
+	case G_FS_FCLOSE_FILE:
+		if ( Bench_Handle( (fileHandle_t)args[0] ) ) {
+			sv.handles[(fileHandle_t)args[0]].file = NULL;
+		}
+		return 0;
+	case G_FS_GETFILELIST:
+		return 0;
+	case G_FS_SEEK:
+		return 0;
+	case G_SEND_CONSOLE_COMMAND:
+		Bench_AppendCommand( (const char *)args[1] );
+		return 0;
+	case G_LOCATE_GAME_DATA:
+		sv.gentities = (byte *)args[0];
+		sv.numEntities = (int)args[1];
+		sv.sizeofEntity = (int)args[2];
+		sv.clients = (byte *)args[3];
+		sv.sizeofClient = (int)args[4];
+		return 0;
+	case G_DROP_CLIENT:
+		sv.vmMain( GAME_CLIENT_DISCONNECT, (int)args[0], 0, 0 );
+		sv.benchClients[(int)args[0]].active = qfalse;
+		return 0;
+	case G_SEND_SERVER_COMMAND:
+		sv.serverCommandBytes += strlen( (const char *)args[1] );
+		return 0;
+	case G_SET_CONFIGSTRING:
+		if ( (unsigned)args[0] < MAX_CONFIGSTRINGS ) {
+			free( sv.configstrings[args[0]] );
+			sv.configstrings[args[0]] = Bench_CopyString( args[1] ? (const char *)args[1] : "" );
+		}
+		return 0;
+	case G_GET_CONFIGSTRING:
+		Bench_Strncpyz( (char *)args[1], (unsigned)args[0] < MAX_CONFIGSTRINGS && sv.configstrings[args[0]]
+			? sv.configstrings[args[0]] : "", (int)args[2] );
+		return 0;
+	case G_GET_USERINFO:
+		Bench_Strncpyz( (char *)args[1], sv.benchClients[(int)args[0]].userinfo, (int)args[2] );
+		return 0;
+	case G_SET_USERINFO:
+		Bench_Strncpyz( sv.benchClients[(int)args[0]].userinfo, (const char *)args[1], MAX_INFO_STRING );
+		return 0;
+	case G_GET_SERVERINFO:
+		Bench_Serverinfo( (char *)args[0], (int)args[1] );
+		return 0;
+	case G_SET_BRUSH_MODEL: {
+		sharedEntity_t *ent = (sharedEntity_t *)args[0];
+
+		ent->s.modelindex = atoi( (const char *)args[1] + 1 );
+		ent->r.bmodel = qtrue;
+		VectorSet( ent->r.mins, -32, -32, -32 );
+		VectorSet( ent->r.maxs, 32, 32, 32 );
+		ent->r.contents = -1;
+		return 0;
+	}
+	case G_TRACE:
+	case G_TRACECAPSULE:
+		Bench_Trace( (trace_t *)args[0], (const float *)args[1], (const float *)args[2], (const float *)args[3],
+			(const float *)args[4], (int)args[5], (int)args[6] );
+		return 0;
+	case G_POINT_CONTENTS:
+		return Bench_PointContents( (const float *)args[0], (int)args[1] );
+	case G_IN_PVS:
+	case G_IN_PVS_IGNORE_PORTALS:
+	case G_AREAS_CONNECTED:
+		return qtrue;
+	case G_ADJUST_AREA_PORTAL_STATE:
+		return 0;
+	case G_LINKENTITY:
+		Bench_LinkEntity( (sharedEntity_t *)args[0] );
+		return 0;
+	case G_UNLINKENTITY:
+		( (sharedEntity_t *)args[0] )->r.linked = qfalse;
+		return 0;
+	case G_ENTITIES_IN_BOX:
+		return Bench_EntitiesInBox( (const float *)args[0], (const float *)args[1], (int *)args[2], (int)args[3] );
+	case G_ENTITY_CONTACT:
+	case G_ENTITY_CONTACTCAPSULE: {
+		const sharedEntity_t *ent = (const sharedEntity_t *)args[2];
+
+		return Bench_BoxesOverlap( (const float *)args[0], (const float *)args[1], ent->r.absmin, ent->r.absmax );
+	}
+	case G_BOT_ALLOCATE_CLIENT:
+		return -1;
+	case G_BOT_FREE_CLIENT:
+		return 0;
+	case G_GET_USERCMD:
+		*(usercmd_t *)args[1] = sv.benchClients[(int)args[0]].cmd;
+		return 0;
+	case G_GET_ENTITY_TOKEN:
+		return Bench_GetEntityToken( (char *)args[0], (int)args[1] );
+	case G_DEBUG_POLYGON_CREATE:
+	case G_DEBUG_POLYGON_DELETE:
+		return 0;
+	case G_REAL_TIME: {
+		qtime_t *qt = (qtime_t *)args[0];
+		time_t t = time( NULL );
+		struct tm *tm = localtime( &t );
+
+		qt->tm_sec = tm->tm_sec;
+		qt->tm_min = tm->tm_min;
+		qt->tm_hour = tm->tm_hour;
+		qt->tm_mday = tm->tm_mday;
+		qt->tm_mon = tm->tm_mon;
+		qt->tm_year = tm->tm_year;
+		qt->tm_wday = tm->tm_wday;
+		qt->tm_yday = tm->tm_yday;
+		qt->tm_isdst = tm->tm_isdst;
+		return (int)t;
+	}
+	case G_SNAPVECTOR: {
+		float *v = (float *)args[0];
+
+		v[0] = rintf( v[0] );
+		v[1] = rintf( v[1] );
+		v[2] = rintf( v[2] );
+		return 0;
+	}
+	case BENCH_GETVALUE:
+		if ( !strcmp( (const char *)args[2], "trap_Microseconds_Trinity" ) ) {
+			snprintf( (char *)args[0], (int)args[1], "%i", BENCH_MICROSECONDS );
+			return qtrue;
+		}
+		return qfalse;
+	case BENCH_MICROSECONDS:
+		return (int)( Bench_Microseconds() - sv.startTime );
+	}
+
+	// botlib is not emulated, bot_enable stays 0
+	return 0;
+}
+
+
+/*
+==============================================================
+
+REPORT
+
+==============================================================
+*/
+
+static int Bench_CompareTimes( const void *a, const void *b ) {
+	long long x = *(const long long *)a, y = *(const long long *)b;
+
+	return ( x > y ) - ( x < y );
+}
+
+
+static void Bench_ReportTimes( const char *label, long long *times, int count ) {
+	long long total;
+	int i;
+
+	if ( !count ) {
+		return;
+	}
+	total = 0;
+	for ( i = 0; i < count; i++ ) {
+		total += times[i];
+	}
+	qsort( times, count, sizeof( times[0] ), Bench_CompareTimes );
+	printf( "%-10s min %7.3f  avg %7.3f  p50 %7.3f  p90 %7.3f  p99 %7.3f  max %7.3f ms\n", label,
+		times[0] / 1000.0, total / 1000.0 / count, times[count / 2] / 1000.0, times[count * 90 / 100] / 1000.0,
+		times[count * 99 / 100] / 1000.0, times[count - 1] / 1000.0 );
+}
+
+
+static void Bench_ReportTraps( int frames ) {
+	int i;
+
+	printf( "\n%-34s %12s %10s\n", "trap", "calls", "per frame" );
+	for ( i = 0; i < MAX_TRAPS; i++ ) {
+		if ( !sv.trapCounts[i] ) {
+			continue;
+		}
+		if ( i < ARRAY_LEN( trapNames ) ) {
+			printf( "%-34s", trapNames[i] );
+		} else if ( i == BENCH_GETVALUE ) {
+			printf( "%-34s", "trap_GetValue" );
+		} else if ( i == BENCH_MICROSECONDS ) {
+			printf( "%-34s", "trap_Microseconds" );
+		} else {
+			printf( "trap #%-28i", i );
+		}
+		printf( " %12lld %10.1f\n", sv.trapCounts[i], (double)sv.trapCounts[i] / frames );
+	}
+	printf( "\nserver command bytes: %lld (%.1f per frame)\n", sv.serverCommandBytes, (double)sv.serverCommandBytes / frames );
+}
+
+
+/*
+==============================================================
+
+MAIN
+
+==============================================================
+*/
+
+static void Bench_Usage( void ) {
+	fprintf( stderr,
+		"usage: gamebench [options] [+set cvar value ...] [+file qpath hostpath ...] [+exec \"command\" ...]\n"
+		"  -game <path>      game module (default dist/baseq3/qagamex86_64.so)\n"
+		"  -clients <n>      scripted clients (default 32)\n"
+		"  -entities <n>     map entities besides worldspawn (default 64)\n"
+		"  -frames <n>       frames to measure (default 2000)\n"
+		"  -warmup <n>       frames to run before measuring (default 100)\n"
+		"  -fps <n>          sv_fps (default 20)\n"
+		"  -cmdrate <n>      usercmds per second per client (default 60)\n"
+		"  -ping <msec>      simulated client latency, exercises lag compensation (default 0)\n"
+		"  -script <name>    fight, strafe or idle (default fight)\n"
+		"  -seed <n>         random seed (default 1)\n"
+		"  -v                print game output\n" );
+	exit( 1 );
+}
+
+
+int main( int argc, char **argv ) {
+	const char		*gamePath = "dist/baseq3/qagamex86_64.so";
+	const char		*execs[MAX_BENCH_EXEC];
+	int				numExecs = 0;
+	int				numClients = 32, numEntities = 64, frames = 2000, warmup = 100;
+	int				fps = 20, cmdRate = 60;
+	benchScript_t	script = SCRIPT_FIGHT;
+	void			*lib;
+	void			(*dllEntry)( dllSyscall_t syscallptr );
+	long long		*frameTimes, *runTimes;
+	int				frameMsec, cmdMsec, frame, i, c;
+	char			buf[16];
+
+	sv.rng = 1;
+
+	for ( i = 1; i < argc; i++ ) {
+		const char *arg = argv[i];
+
+		if ( !strcmp( arg, "-v" ) ) {
+			sv.verbose = qtrue;
+		} else if ( !strcmp( arg, "+set" ) && i + 2 < argc ) {
+			Bench_CvarSet( argv[i + 1], argv[i + 2] );
+			i += 2;
+		} else if ( !strcmp( arg, "+file" ) && i + 2 < argc ) {
+			Bench_AddHostFile( argv[i + 1], argv[i + 2] );
+			i += 2;
+		} else if ( !strcmp( arg, "+exec" ) && i + 1 < argc ) {
+			if ( numExecs < MAX_BENCH_EXEC ) {
+				execs[numExecs++] = argv[i + 1];
+			}
+			i++;
+		} else if ( i + 1 >= argc ) {
+			Bench_Usage();
+		} else if ( !strcmp( arg, "-game" ) ) {
+			gamePath = argv[++i];
+		} else if ( !strcmp( arg, "-clients" ) ) {
+			numClients = atoi( argv[++i] );
+		} else if ( !strcmp( arg, "-entities" ) ) {
+			numEntities = atoi( argv[++i] );
+		} else if ( !strcmp( arg, "-frames" ) ) {
+			frames = atoi( argv[++i] );
+		} else if ( !strcmp( arg, "-warmup" ) ) {
+			warmup = atoi( argv[++i] );
+		} else if ( !strcmp( arg, "-fps" ) ) {
+			fps = atoi( argv[++i] );
+		} else if ( !strcmp( arg, "-cmdrate" ) ) {
+			cmdRate = atoi( argv[++i] );
+		} else if ( !strcmp( arg, "-ping" ) ) {
+			sv.ping = atoi( argv[++i] );
+		} else if ( !strcmp( arg, "-seed" ) ) {
+			sv.rng = atoi( argv[++i] );
+		} else if ( !strcmp( arg, "-script" ) ) {
+			arg = argv[++i];
+			if ( !strcmp( arg, "fight" ) ) {
+				script = SCRIPT_FIGHT;
+			} else if ( !strcmp( arg, "strafe" ) ) {
+				script = SCRIPT_STRAFE;
+			} else if ( !strcmp( arg, "idle" ) ) {
+				script = SCRIPT_IDLE;
+			} else {
+				Bench_Usage();
+			}
+		} else {
+			Bench_Usage();
+		}
+	}
+
+	if ( numClients < 0 || numClients > MAX_CLIENTS || fps < 1 || cmdRate < 1 || frames < 1 ) {
+		Bench_Usage();
+	}
+
+	lib = dlopen( gamePath, RTLD_NOW | RTLD_LOCAL );
+	if ( !lib ) {
+		Bench_Error( "%s\n", dlerror() );
+	}
+	dllEntry = (void (*)( dllSyscall_t ))dlsym( lib, "dllEntry" );
+	sv.vmMain = (intptr_t (*)( int, int, int, int ))dlsym( lib, "vmMain" );
+	if ( !dllEntry || !sv.vmMain ) {
+		Bench_Error( "%s is not a game module\n", gamePath );
+	}
+	dllEntry( Bench_Syscall );
+
+	// engine side cvars, command line values win
+	snprintf( buf, sizeof( buf ), "%i", numClients > 8 ? numClients : 8 );
+	Bench_CvarGet( "sv_maxclients", buf, CVAR_SERVERINFO | CVAR_LATCH );
+	snprintf( buf, sizeof( buf ), "%i", fps );
+	Bench_CvarGet( "sv_fps", buf, CVAR_SERVERINFO );
+	snprintf( buf, sizeof( buf ), "%i", BENCH_GETVALUE );
+	Bench_CvarGet( "//trap_GetValue", buf, CVAR_ROM );
+	Bench_CvarGet( "mapname", "gamebench", CVAR_SERVERINFO | CVAR_ROM );
+	Bench_CvarGet( "sv_hostname", "gamebench", CVAR_SERVERINFO );
+	Bench_CvarGet( "dedicated", "1", CVAR_ROM );
+	Bench_CvarGet( "bot_enable", "0", CVAR_ROM );
+	Bench_CvarGet( "g_log", "", 0 );
+	Bench_CvarGet( "sessionMapIndex", "1", 0 );		// keep the rotation system from changing maps
+	Bench_CvarGet( "timelimit", "0", CVAR_SERVERINFO );
+	Bench_CvarGet( "fraglimit", "0", CVAR_SERVERINFO );
+
+	Bench_BuildWorld( 2048, 512 );
+	Bench_BuildMap( numEntities, 2048 );
+
+	sv.startTime = Bench_Microseconds();
+	sv.levelTime = 1000;
+	sv.vmMain( GAME_INIT, sv.levelTime, sv.rng, qfalse );
+
+	for ( c = 0; c < numClients; c++ ) {
+		Bench_ConnectClient( c, qtrue );
+	}
+
+	frameMsec = 1000 / fps;
+	cmdMsec = 1000 / cmdRate;
+	if ( cmdMsec < 1 ) {
+		cmdMsec = 1;
+	}
+
+	frameTimes = calloc( frames, sizeof( *frameTimes ) );
+	runTimes = calloc( frames, sizeof( *runTimes ) );
+	memset( sv.trapCounts, 0, sizeof( sv.trapCounts ) );
+
+	for ( frame = -warmup; frame < frames; frame++ ) {
+		long long t0, t1, t2;
+		int cmdTime;
+
+		if ( frame == 0 ) {
+			memset( sv.trapCounts, 0, sizeof( sv.trapCounts ) );
+			sv.serverCommandBytes = 0;
+		}
+
+		t0 = Bench_Microseconds();
+
+		// client packets arriving between the previous and this frame
+		for ( cmdTime = sv.levelTime + cmdMsec; cmdTime <= sv.levelTime + frameMsec; cmdTime += cmdMsec ) {
+			for ( c = 0; c < numClients; c++ ) {
+				if ( !sv.benchClients[c].active ) {
+					continue;
+				}
+				Bench_BuildUsercmd( c, cmdTime, script, numClients );
+				sv.vmMain( GAME_CLIENT_THINK, c, 0, 0 );
+			}
+		}
+
+		sv.levelTime += frameMsec;
+
+		t1 = Bench_Microseconds();
+		sv.vmMain( GAME_RUN_FRAME, sv.levelTime, 0, 0 );
+		t2 = Bench_Microseconds();
+
+		if ( frame >= 0 ) {
+			frameTimes[frame] = t2 - t0;
+			runTimes[frame] = t2 - t1;
+		}
+
+		Bench_ExecuteCommands();
+	}
+
+	printf( "gamebench: %s, %i clients, %i entities, %i frames at sv_fps %i, %i usercmds/s, %i msec ping\n\n",
+		gamePath, numClients, numEntities, frames, fps, cmdRate, sv.ping );
+	Bench_ReportTimes( "frame", frameTimes, frames );
+	Bench_ReportTimes( "runframe", runTimes, frames );
+	Bench_ReportTraps( frames );
+
+	sv.verbose = qtrue;
+	for ( i = 0; i < numExecs; i++ ) {
+		printf( "\n] %s\n", execs[i] );
+		Bench_TokenizeString( execs[i] );
+		if ( !sv.vmMain( GAME_CONSOLE_COMMAND, 0, 0, 0 ) ) {
+			printf( "unknown command: %s\n", sv.argc ? sv.argv[0] : "" );
+		}
+	}
+
+	sv.verbose = qfalse;
+	sv.vmMain( GAME_SHUTDOWN, qfalse, 0, 0 );
+	dlclose( lib );
+
+	return 0;
+}